@@ -3,7 +3,43 @@
 #include <queue>  // Para BFS
 #include <stack>  // Para DFS
 #include <chrono> // Para medir o tempo de execução
-#include <set>    // Para armazenar estados visitados
+#include <cstdint> // Para as chaves compactas de estado
+#include <algorithm>
+#include <string>
+#include <thread>             // Para as buscas paralelas
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <limits>
+#include <map>
+#include <set>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <list>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <filesystem> // Para os arquivos da BFS em memória externa
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h> // Para o pico de memória no benchmark
+#else
+#include <sys/resource.h> // Para o pico de memória no benchmark
+#include <sys/wait.h>
+#include <sys/socket.h>   // Para o modo serviço em socket local
+#include <sys/un.h>
+#include <sys/mman.h> // Para mapear as bases de soluções pré-computadas
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <csignal>
+#include <cerrno>
+#endif
 
 using namespace std;
 using namespace std::chrono;
@@ -85,512 +121,8073 @@ vector<int> converterEstado(const vector<Capacidade> &jarros)
     return estado;
 }
 
-// Função de heurística para Busca Gulosa
-int heuristica(const vector<Capacidade> &jarros)
+// Descrição da instância: os dados dos jarros que não mudam durante a busca.
+// É compartilhada por todos os nós, que guardam apenas os níveis atuais.
+struct Instancia
 {
-    int heuristica = 0;
+    int n = 0;
+    vector<int> capacidadeMax;
+    vector<int> objetivo;
+};
+
+Instancia criarInstancia(const vector<Capacidade> &jarros)
+{
+    Instancia inst;
+    inst.n = static_cast<int>(jarros.size());
     for (const auto &jarro : jarros)
     {
-        heuristica += abs(jarro.capacidadeAtual - jarro.objetivo);
+        inst.capacidadeMax.push_back(jarro.capacidadeMax);
+        inst.objetivo.push_back(jarro.objetivo);
     }
-    return heuristica;
+    return inst;
 }
 
-// Função para exibir estatísticas de busca
-void exibirEstatisticas(const string &metodo, const vector<vector<int>> &caminho, int nosVisitados, int nosExpandidos, double fatorRamificacao, long long tempoExecucao)
+// Indica se cada objetivo está entre 0 e a capacidade do seu jarro. Fora
+// disso não há solução, e as buscas com chave compacta ou índice denso não
+// podem codificar o objetivo: o valor transbordaria para outro estado.
+bool objetivoCabe(const Instancia &inst)
 {
-    cout << "-----------------------------" << endl;
-    cout << "Metodo de Busca: " << metodo << endl;
-    cout << "Caminho da Solucao:" << endl;
-    for (const auto &estado : caminho)
+    for (int i = 0; i < inst.n; ++i)
     {
-        for (int cap : estado)
-            cout << cap << " ";
-        cout << endl;
+        if (inst.objetivo[i] < 0 || inst.objetivo[i] > inst.capacidadeMax[i])
+            return false;
     }
-    cout << "Profundidade da Solucao: " << caminho.size() - 1 << endl;
-    cout << "Custo da Solucao: " << caminho.size() - 1 << endl; // Custo unitário por passo
-    cout << "Numero Total de Nos Visitados: " << nosVisitados << endl;
-    cout << "Numero Total de Nos Expandidos: " << nosExpandidos << endl;
-    cout << "Valor Medio do Fator de Ramificacao: " << fatorRamificacao << endl;
-    cout << "Tempo de Execucao: " << tempoExecucao << " ms" << endl;
-    cout << "-----------------------------" << endl;
+    return true;
 }
 
-// Função de Backtracking
-bool backtracking(vector<Capacidade> &jarros, set<vector<int>> &visitado, vector<vector<int>> &caminho, int &nosExpandidos)
+// Função para verificar se os níveis atingiram o objetivo de todos os jarros
+bool atingiuObjetivos(const Instancia &inst, const int *niveis)
 {
-    if (todosAtingiramObjetivo(jarros))
+    for (int i = 0; i < inst.n; ++i)
     {
-        caminho.push_back(converterEstado(jarros)); // Inclui o estado final
-        return true;
+        if (niveis[i] != inst.objetivo[i])
+            return false;
     }
+    return true;
+}
 
-    // Cria um estado atual para verificar se já foi visitado
-    vector<int> estadoAtual = converterEstado(jarros);
-
-    if (visitado.count(estadoAtual))
-        return false;
-
-    visitado.insert(estadoAtual);
-    caminho.push_back(estadoAtual);
+enum TipoMovimento
+{
+    TRANSFERIR,
+    ENCHER,
+    ESVAZIAR
+};
 
-    nosExpandidos++; // Contador de nós expandidos
+// Movimento sobre os jarros; em ENCHER e ESVAZIAR apenas 'de' é usado
+struct Movimento
+{
+    TipoMovimento tipo = TRANSFERIR;
+    int de = 0;
+    int para = 0;
+};
 
-    // Tenta encher, esvaziar, e transferir entre os jarros
-    for (int i = 0; i < jarros.size(); ++i)
+// Ordem de geração dos sucessores: para cada jarro i, transferir de i para
+// cada j, encher i e esvaziar i
+vector<Movimento> listarMovimentos(int n)
+{
+    vector<Movimento> movimentos;
+    for (int i = 0; i < n; ++i)
     {
-        vector<Capacidade> novoEstado = jarros;
-
-        // Tenta transferir água entre jarros
-        for (int j = 0; j < jarros.size(); ++j)
+        for (int j = 0; j < n; ++j)
         {
             if (i != j)
-            {
-                novoEstado = jarros;
-                transferirAgua(novoEstado, i, j);
-                if (backtracking(novoEstado, visitado, caminho, nosExpandidos))
-                    return true;
-            }
+                movimentos.push_back({TRANSFERIR, i, j});
         }
-
-        // Tenta encher o jarro i
-        encherJarro(novoEstado, i);
-        if (backtracking(novoEstado, visitado, caminho, nosExpandidos))
-            return true;
-
-        // Tenta esvaziar o jarro i
-        novoEstado = jarros;
-        esvaziarJarro(novoEstado, i);
-        if (backtracking(novoEstado, visitado, caminho, nosExpandidos))
-            return true;
+        movimentos.push_back({ENCHER, i, i});
+        movimentos.push_back({ESVAZIAR, i, i});
     }
-
-    caminho.pop_back(); // Remove o estado se não conduzir à solução
-    return false;
+    return movimentos;
 }
 
-void buscaBacktrackingRecursiva(const vector<Capacidade> &jarros)
+// Aplica o movimento sobre os níveis e retorna a quantidade de água que mudou
+int aplicarMovimento(const Instancia &inst, int *niveis, const Movimento &mov)
 {
-    vector<Capacidade> estadoInicial = jarros;
-    set<vector<int>> visitado;
-    vector<vector<int>> caminho;
-    int nosExpandidos = 0;
-
-    auto start = high_resolution_clock::now();
-
-    if (backtracking(estadoInicial, visitado, caminho, nosExpandidos))
-    {
-        int nosVisitados = visitado.size();
-        double fatorRamificacao = (nosVisitados > 1) ? static_cast<double>(nosExpandidos) / (nosVisitados - 1) : 0;
-        auto stop = high_resolution_clock::now();
-        auto duration = duration_cast<milliseconds>(stop - start).count();
-        exibirEstatisticas("Busca em Backtracking", caminho, nosVisitados, nosExpandidos, fatorRamificacao, duration);
-    }
-    else
+    int quantidade = 0;
+    switch (mov.tipo)
     {
-        cout << "Nenhuma solução encontrada." << endl;
+    case TRANSFERIR:
+        quantidade = min(niveis[mov.de], inst.capacidadeMax[mov.para] - niveis[mov.para]);
+        niveis[mov.de] -= quantidade;
+        niveis[mov.para] += quantidade;
+        break;
+    case ENCHER:
+        quantidade = inst.capacidadeMax[mov.de] - niveis[mov.de];
+        niveis[mov.de] = inst.capacidadeMax[mov.de];
+        break;
+    case ESVAZIAR:
+        quantidade = niveis[mov.de];
+        niveis[mov.de] = 0;
+        break;
     }
+    return quantidade;
 }
 
-// Função de Busca em Largura (BFS)
-void buscaEmLargura(const vector<Capacidade> &jarros)
+// Gera os predecessores do estado: todos os estados diferentes dele que chegam
+// a ele com um único movimento (encherJarro, esvaziarJarro ou transferirAgua).
+// Os níveis de cada predecessor são acrescentados em 'saida', n inteiros por estado.
+void gerarPredecessores(const Instancia &inst, const int *niveis, vector<int> &saida)
 {
-    cout << "Iniciando Busca em Largura..." << endl;
-
-    queue<vector<Capacidade>> fila;
-    set<vector<int>> visitado;
-    vector<vector<int>> caminho;
-    int nosVisitados = 0, nosExpandidos = 0;
-
-    fila.push(jarros);
-    auto start = high_resolution_clock::now();
-
-    while (!fila.empty())
+    int n = inst.n;
+    auto emitir = [&](int a, int valorA, int b, int valorB)
     {
-        vector<Capacidade> estadoAtual = fila.front();
-        fila.pop();
-
-        vector<int> estado = converterEstado(estadoAtual);
-        if (visitado.count(estado))
-            continue;
-
-        visitado.insert(estado);
-        caminho.push_back(estado);
-        nosExpandidos++;
+        size_t inicio = saida.size();
+        saida.insert(saida.end(), niveis, niveis + n);
+        saida[inicio + a] = valorA;
+        saida[inicio + b] = valorB;
+    };
 
-        // Verifica se atingimos o objetivo
-        if (todosAtingiramObjetivo(estadoAtual))
+    for (int i = 0; i < n; ++i)
+    {
+        // Encher i: o jarro está cheio e antes podia ter qualquer nível menor
+        if (niveis[i] == inst.capacidadeMax[i])
         {
-            nosVisitados = visitado.size();
-            double fatorRamificacao = (nosVisitados > 1) ? static_cast<double>(nosExpandidos) / (nosVisitados - 1) : 0;
-            auto stop = high_resolution_clock::now();
-            auto duration = duration_cast<milliseconds>(stop - start).count();
-            exibirEstatisticas("Busca em Largura", caminho, nosVisitados, nosExpandidos, fatorRamificacao, duration);
-            return;
+            for (int v = 0; v < inst.capacidadeMax[i]; ++v)
+                emitir(i, v, i, v);
         }
 
-        // Gera estados filhos
-        for (int i = 0; i < estadoAtual.size(); ++i)
+        // Esvaziar i: o jarro está vazio e antes podia ter qualquer nível positivo
+        if (niveis[i] == 0)
         {
-            vector<Capacidade> novoEstado = estadoAtual;
-
-            // Transferir água entre jarros
-            for (int j = 0; j < estadoAtual.size(); ++j)
-            {
-                if (i != j)
-                {
-                    novoEstado = estadoAtual;
-                    transferirAgua(novoEstado, i, j);
-                    fila.push(novoEstado);
-                }
-            }
-            // Encher jarro
-            encherJarro(novoEstado, i);
-            fila.push(novoEstado);
+            for (int v = 1; v <= inst.capacidadeMax[i]; ++v)
+                emitir(i, v, i, v);
+        }
 
-            // Esvaziar jarro
-            novoEstado = estadoAtual;
-            esvaziarJarro(novoEstado, i);
-            fila.push(novoEstado);
+        // Transferir de i para j: a transferência para quando i esvazia ou j
+        // enche, então um desses dois precisa valer no estado resultante
+        for (int j = 0; j < n; ++j)
+        {
+            if (i == j || (niveis[i] != 0 && niveis[j] != inst.capacidadeMax[j]))
+                continue;
+            int maximo = min(niveis[j], inst.capacidadeMax[i] - niveis[i]);
+            for (int q = 1; q <= maximo; ++q)
+                emitir(i, niveis[i] + q, j, niveis[j] - q);
         }
     }
 }
 
-// Função de Busca em Profundidade (DFS) usando Pilha
-void buscaEmProfundidade(const vector<Capacidade> &jarros)
+// Chave compacta de um estado: os níveis dos jarros empacotados em até 128 bits
+struct ChaveEstado
 {
-    cout << "Iniciando Busca em Profundidade..." << endl;
+    uint64_t baixo = 0;
+    uint64_t alto = 0;
 
-    stack<vector<Capacidade>> pilha;
-    set<vector<int>> visitado;
-    vector<vector<int>> caminho;
-    int nosVisitados = 0, nosExpandidos = 0;
-
-    pilha.push(jarros);
-    auto start = high_resolution_clock::now();
+    bool operator==(const ChaveEstado &outra) const
+    {
+        return baixo == outra.baixo && alto == outra.alto;
+    }
 
-    while (!pilha.empty())
+    // Ordem numérica do valor de 128 bits (usada pelos arquivos ordenados)
+    bool operator<(const ChaveEstado &outra) const
     {
-        vector<Capacidade> estadoAtual = pilha.top();
-        pilha.pop();
+        return alto != outra.alto ? alto < outra.alto : baixo < outra.baixo;
+    }
+};
 
-        vector<int> estado = converterEstado(estadoAtual);
-        if (visitado.count(estado))
-            continue;
+// Função de mistura de bits (finalizador do splitmix64) usada pelas tabelas hash
+inline uint64_t misturarBits(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
 
-        visitado.insert(estado);
-        caminho.push_back(estado);
-        nosExpandidos++;
+inline uint64_t hashChave(const ChaveEstado &chave)
+{
+    return misturarBits(chave.baixo ^ misturarBits(chave.alto + 0x9e3779b97f4a7c15ULL));
+}
 
-        // Verifica se atingimos o objetivo
-        if (todosAtingiramObjetivo(estadoAtual))
+// Empacota os níveis dos jarros em bits, reservando para cada jarro
+// apenas os bits necessários para representar sua capacidadeMax
+class CodificadorEstado
+{
+public:
+    explicit CodificadorEstado(const Instancia &inst)
+    {
+        int posicao = 0;
+        for (int capacidade : inst.capacidadeMax)
         {
-            nosVisitados = visitado.size();
-            double fatorRamificacao = (nosVisitados > 1) ? static_cast<double>(nosExpandidos) / (nosVisitados - 1) : 0;
-            auto stop = high_resolution_clock::now();
-            auto duration = duration_cast<milliseconds>(stop - start).count();
-            exibirEstatisticas("Busca em Profundidade", caminho, nosVisitados / 2, nosExpandidos / 2, fatorRamificacao, duration / 2);
-            return;
+            int largura = 1;
+            while (largura < 31 && (capacidade >> largura) != 0)
+                largura++;
+            bits.push_back(largura);
+            deslocamento.push_back(posicao);
+            posicao += largura;
         }
+        totalBits = posicao;
+    }
 
-        // Gera estados filhos (em ordem reversa para simular a pilha)
-        for (int i = estadoAtual.size() - 1; i >= 0; --i)
-        {
-            vector<Capacidade> novoEstado = estadoAtual;
+    // Indica se o estado cabe em uma chave de 128 bits
+    bool cabe() const { return totalBits <= 128; }
+    int bitsTotais() const { return totalBits; }
 
-            // Transferir água entre jarros
-            for (int j = estadoAtual.size() - 1; j >= 0; --j)
-            {
-                if (i != j)
-                {
-                    novoEstado = estadoAtual;
-                    transferirAgua(novoEstado, i, j);
-                    pilha.push(novoEstado);
-                }
-            }
+    ChaveEstado codificar(const int *niveis) const
+    {
+        ChaveEstado chave;
+        for (size_t i = 0; i < bits.size(); ++i)
+            colocar(chave, i, niveis[i]);
+        return chave;
+    }
+
+    void decodificar(const ChaveEstado &chave, int *niveis) const
+    {
+        for (size_t i = 0; i < bits.size(); ++i)
+        {
+            int pos = deslocamento[i];
+            uint64_t mascara = (1ULL << bits[i]) - 1;
+            uint64_t valor;
+            if (pos >= 64)
+                valor = chave.alto >> (pos - 64);
+            else if (pos + bits[i] <= 64)
+                valor = chave.baixo >> pos;
+            else
+                valor = (chave.baixo >> pos) | (chave.alto << (64 - pos));
+            niveis[i] = static_cast<int>(valor & mascara);
+        }
+    }
 
-            // Esvaziar jarro
-            novoEstado = estadoAtual;
-            esvaziarJarro(novoEstado, i);
-            pilha.push(novoEstado);
+private:
+    vector<int> bits;
+    vector<int> deslocamento;
+    int totalBits = 0;
 
-            // Encher jarro
-            novoEstado = estadoAtual;
-            encherJarro(novoEstado, i);
-            pilha.push(novoEstado);
+    void colocar(ChaveEstado &chave, size_t i, int nivel) const
+    {
+        uint64_t valor = static_cast<uint64_t>(nivel);
+        int pos = deslocamento[i];
+        if (pos >= 64)
+        {
+            chave.alto |= valor << (pos - 64);
+        }
+        else
+        {
+            chave.baixo |= valor << pos;
+            if (pos + bits[i] > 64)
+                chave.alto |= valor >> (64 - pos);
         }
     }
-}
+};
 
-// Função de Busca de Custo Uniforme
-void buscaOrdenada(const vector<Capacidade> &jarros)
+// Conjunto de estados visitados com endereçamento aberto (sondagem linear).
+// Usa as chaves compactas quando o estado cabe em 128 bits; caso contrário,
+// guarda os níveis em um vetor contíguo e a tabela armazena apenas índices.
+class ConjuntoVisitados
 {
-    cout << "Iniciando Busca Ordenada ..." << endl;
-    auto cmp = [](const pair<vector<Capacidade>, int> &a, const pair<vector<Capacidade>, int> &b)
+public:
+    // Com 'numerado' cada estado recebe um número de ordem (ver numerar),
+    // ao custo de 4 bytes por posição da tabela no modo compacto
+    explicit ConjuntoVisitados(const Instancia &inst, bool numerado = false)
+        : codificador(inst), n(inst.n), compacto(codificador.cabe()), numerado(numerado)
     {
-        return a.second > b.second; // Min-heap com base no custo acumulado
-    };
-    priority_queue<pair<vector<Capacidade>, int>, vector<pair<vector<Capacidade>, int>>, decltype(cmp)> fila(cmp);
-    set<vector<int>> visitado;
-    vector<vector<int>> caminho;
-    int nosVisitados = 0, nosExpandidos = 0;
+        redimensionar(1024);
+    }
 
-    fila.push({jarros, 0}); // {estado, custo}
+    // Insere o estado; retorna true se ele ainda não estava no conjunto
+    bool inserir(const int *niveis)
+    {
+        if (compacto)
+            return inserirChave(codificador.codificar(niveis)) != SEM_POSICAO;
+        return inserirNiveis(niveis) != SEM_POSICAO;
+    }
 
-    auto start = high_resolution_clock::now();
+    bool contem(const int *niveis) const { return localizar(niveis) != SEM_POSICAO; }
 
-    while (!fila.empty())
+    // Insere o estado se preciso e retorna o seu número de ordem (0, 1, 2...
+    // na ordem de inserção), para guardar dados do estado num vetor à parte;
+    // 'novo' indica se ele acabou de entrar. Exige o conjunto 'numerado'.
+    uint32_t numerar(const int *niveis, bool &novo)
     {
-        auto [estadoAtual, custoAtual] = fila.top();
-        fila.pop();
+        size_t pos = localizar(niveis);
+        novo = pos == SEM_POSICAO;
+        if (novo)
+            pos = compacto ? inserirChave(codificador.codificar(niveis)) : inserirNiveis(niveis);
+        return indices[pos];
+    }
 
-        vector<int> estado = converterEstado(estadoAtual);
+    size_t size() const { return quantidade; }
 
-        if (visitado.count(estado))
-            continue;
+    size_t bytes() const
+    {
+        return marcas.capacity() + chaves.capacity() * sizeof(ChaveEstado) + indices.capacity() * sizeof(uint32_t) +
+               niveisGuardados.capacity() * sizeof(int);
+    }
 
-        visitado.insert(estado);
-        caminho.push_back(estado);
-        nosExpandidos++;
+private:
+    static constexpr size_t SEM_POSICAO = static_cast<size_t>(-1);
+
+    CodificadorEstado codificador;
+    int n;
+    bool compacto;
+    bool numerado;
+    size_t quantidade = 0;
+    size_t mascara = 0;
+    vector<uint8_t> marcas;       // 0 = posição livre; senão, 0x80 | 7 bits do hash
+    vector<ChaveEstado> chaves;   // modo compacto
+    vector<uint32_t> indices;     // número de ordem do estado (no modo alternativo, também em niveisGuardados)
+    vector<int> niveisGuardados;  // modo alternativo: níveis de todos os estados, contíguos
+
+    static uint8_t marcaDe(uint64_t hash) { return static_cast<uint8_t>(0x80 | (hash >> 57)); }
 
-        if (todosAtingiramObjetivo(estadoAtual))
+    uint64_t hashNiveis(const int *niveis) const
+    {
+        uint64_t h = 0x84222325cbf29ce4ULL;
+        for (int i = 0; i < n; ++i)
+            h = misturarBits(h ^ static_cast<uint32_t>(niveis[i]));
+        return h;
+    }
+
+    size_t localizar(const int *niveis) const
+    {
+        if (compacto)
         {
-            nosVisitados = visitado.size();
-            double fatorRamificacao = (nosVisitados > 1) ? static_cast<double>(nosExpandidos) / (nosVisitados - 1) : 0;
-            auto stop = high_resolution_clock::now();
-            auto duration = duration_cast<milliseconds>(stop - start).count();
-            exibirEstatisticas("Busca Ordenada", caminho, nosVisitados, nosExpandidos, fatorRamificacao, duration);
-            return;
+            ChaveEstado chave = codificador.codificar(niveis);
+            return localizarChave(chave, hashChave(chave));
         }
+        return localizarNiveis(niveis, hashNiveis(niveis));
+    }
 
-        // Gerar novos estados
-        for (int i = 0; i < estadoAtual.size(); ++i)
+    size_t localizarChave(const ChaveEstado &chave, uint64_t hash) const
+    {
+        uint8_t marca = marcaDe(hash);
+        for (size_t pos = hash & mascara;; pos = (pos + 1) & mascara)
         {
-            vector<Capacidade> novoEstado = estadoAtual;
-
-            // Transferir água entre jarros
-            for (int j = 0; j < estadoAtual.size(); ++j)
-            {
-                if (i != j)
-                {
-                    novoEstado = estadoAtual;
-                    transferirAgua(novoEstado, i, j);
-                    if (!visitado.count(converterEstado(novoEstado)))
-                        fila.push({novoEstado, custoAtual + 1});
-                }
-            }
-            // Encher jarro
-            encherJarro(novoEstado, i);
-            if (!visitado.count(converterEstado(novoEstado)))
-                fila.push({novoEstado, custoAtual + 1});
-
-            // Esvaziar jarro
-            novoEstado = estadoAtual;
-            esvaziarJarro(novoEstado, i);
-            if (!visitado.count(converterEstado(novoEstado)))
-                fila.push({novoEstado, custoAtual + 1});
+            if (marcas[pos] == 0)
+                return SEM_POSICAO;
+            if (marcas[pos] == marca && chaves[pos] == chave)
+                return pos;
+        }
+    }
 
+    size_t localizarNiveis(const int *niveis, uint64_t hash) const
+    {
+        uint8_t marca = marcaDe(hash);
+        for (size_t pos = hash & mascara;; pos = (pos + 1) & mascara)
+        {
+            if (marcas[pos] == 0)
+                return SEM_POSICAO;
+            if (marcas[pos] == marca && equal(niveis, niveis + n, &niveisGuardados[static_cast<size_t>(indices[pos]) * n]))
+                return pos;
         }
     }
 
-    cout << "Nenhuma solucao encontrada." << endl;
-}
+    // Retornam a posição do novo estado, ou SEM_POSICAO se ele já existia
+    size_t inserirChave(const ChaveEstado &chave)
+    {
+        uint64_t hash = hashChave(chave);
+        if (localizarChave(chave, hash) != SEM_POSICAO)
+            return SEM_POSICAO;
+        crescerSeNecessario();
+        size_t pos = hash & mascara;
+        while (marcas[pos] != 0)
+            pos = (pos + 1) & mascara;
+        marcas[pos] = marcaDe(hash);
+        chaves[pos] = chave;
+        if (numerado)
+            indices[pos] = static_cast<uint32_t>(quantidade);
+        quantidade++;
+        return pos;
+    }
 
-// Função de Busca Gulosa
-void buscaGulosa(const vector<Capacidade> &jarros)
-{
-    cout << "Iniciando Busca Gulosa..." << endl;
+    size_t inserirNiveis(const int *niveis)
+    {
+        uint64_t hash = hashNiveis(niveis);
+        if (localizarNiveis(niveis, hash) != SEM_POSICAO)
+            return SEM_POSICAO;
+        crescerSeNecessario();
+        size_t pos = hash & mascara;
+        while (marcas[pos] != 0)
+            pos = (pos + 1) & mascara;
+        marcas[pos] = marcaDe(hash);
+        indices[pos] = static_cast<uint32_t>(niveisGuardados.size() / n);
+        niveisGuardados.insert(niveisGuardados.end(), niveis, niveis + n);
+        quantidade++;
+        return pos;
+    }
 
-    auto cmp = [](const pair<vector<Capacidade>, int> &a, const pair<vector<Capacidade>, int> &b)
+    void crescerSeNecessario()
     {
-        return a.second > b.second; // Min-heap com base na heurística
-    };
-    priority_queue<pair<vector<Capacidade>, int>, vector<pair<vector<Capacidade>, int>>, decltype(cmp)> fila(cmp);
-    set<vector<int>> visitado;
-    vector<vector<int>> caminho;
-    int nosVisitados = 0, nosExpandidos = 0;
+        // Mantém a ocupação abaixo de 70% para sondagens curtas
+        if ((quantidade + 1) * 10 > marcas.size() * 7)
+            redimensionar(marcas.size() * 2);
+    }
+
+    void redimensionar(size_t novoTamanho)
+    {
+        vector<uint8_t> marcasAntigas;
+        vector<ChaveEstado> chavesAntigas;
+        vector<uint32_t> indicesAntigos;
+        marcasAntigas.swap(marcas);
+        chavesAntigas.swap(chaves);
+        indicesAntigos.swap(indices);
 
-    fila.push({jarros, heuristica(jarros)});
+        marcas.assign(novoTamanho, 0);
+        if (compacto)
+            chaves.resize(novoTamanho);
+        if (!compacto || numerado)
+            indices.resize(novoTamanho);
+        mascara = novoTamanho - 1;
 
-    auto start = high_resolution_clock::now();
+        for (size_t antigo = 0; antigo < marcasAntigas.size(); ++antigo)
+        {
+            if (marcasAntigas[antigo] == 0)
+                continue;
+            uint64_t hash = compacto ? hashChave(chavesAntigas[antigo])
+                                     : hashNiveis(&niveisGuardados[static_cast<size_t>(indicesAntigos[antigo]) * n]);
+            size_t pos = hash & mascara;
+            while (marcas[pos] != 0)
+                pos = (pos + 1) & mascara;
+            marcas[pos] = marcasAntigas[antigo];
+            if (compacto)
+                chaves[pos] = chavesAntigas[antigo];
+            if (!compacto || numerado)
+                indices[pos] = indicesAntigos[antigo];
+        }
+    }
+};
 
-    while (!fila.empty())
+// Tabela hash genérica de chaves compactas para valores, com endereçamento
+// aberto; usada pelos modos de busca que precisam associar dados a cada estado
+template <typename Valor>
+class TabelaChaves
+{
+public:
+    explicit TabelaChaves(size_t capacidadeInicial = 1024)
     {
-        auto [estadoAtual, heuristicaAtual] = fila.top();
-        fila.pop();
+        size_t tamanho = 16;
+        while (tamanho < capacidadeInicial)
+            tamanho *= 2;
+        marcas.assign(tamanho, 0);
+        chaves.resize(tamanho);
+        valores.resize(tamanho);
+        mascara = tamanho - 1;
+    }
 
-        vector<int> estado = converterEstado(estadoAtual);
+    // Insere a chave com o valor se ela ainda não existir;
+    // retorna o ponteiro para o valor guardado e se houve inserção
+    pair<Valor *, bool> inserir(const ChaveEstado &chave, const Valor &valor)
+    {
+        uint64_t hash = hashChave(chave);
+        size_t pos = localizar(chave, hash);
+        if (pos != SEM_POSICAO)
+            return {&valores[pos], false};
+        if ((quantidade + 1) * 10 > marcas.size() * 7)
+            redimensionar(marcas.size() * 2);
+        pos = hash & mascara;
+        while (marcas[pos] != 0)
+            pos = (pos + 1) & mascara;
+        marcas[pos] = marcaDe(hash);
+        chaves[pos] = chave;
+        valores[pos] = valor;
+        quantidade++;
+        return {&valores[pos], true};
+    }
 
-        if (visitado.count(estado))
-            continue;
+    Valor *buscar(const ChaveEstado &chave)
+    {
+        size_t pos = localizar(chave, hashChave(chave));
+        return pos == SEM_POSICAO ? nullptr : &valores[pos];
+    }
 
-        visitado.insert(estado);
-        caminho.push_back(estado);
-        nosExpandidos++;
+    const Valor *buscar(const ChaveEstado &chave) const
+    {
+        size_t pos = localizar(chave, hashChave(chave));
+        return pos == SEM_POSICAO ? nullptr : &valores[pos];
+    }
 
-        if (todosAtingiramObjetivo(estadoAtual))
+    // Remove a chave, puxando para trás as chaves seguintes do mesmo trecho
+    // de sondagem (sem marcas de remoção); retorna se ela existia
+    bool remover(const ChaveEstado &chave)
+    {
+        size_t vazio = localizar(chave, hashChave(chave));
+        if (vazio == SEM_POSICAO)
+            return false;
+        for (size_t pos = (vazio + 1) & mascara; marcas[pos] != 0; pos = (pos + 1) & mascara)
         {
-            nosVisitados = visitado.size();
-            double fatorRamificacao = (nosVisitados > 1) ? static_cast<double>(nosExpandidos) / (nosVisitados - 1) : 0;
-            auto stop = high_resolution_clock::now();
-            auto duration = duration_cast<milliseconds>(stop - start).count();
-            exibirEstatisticas("Busca Gulosa", caminho, nosVisitados, nosExpandidos, fatorRamificacao, duration);
-            return;
+            size_t ideal = hashChave(chaves[pos]) & mascara;
+            if (((pos - ideal) & mascara) < ((pos - vazio) & mascara))
+                continue; // a posição ideal está entre o buraco e 'pos'
+            marcas[vazio] = marcas[pos];
+            chaves[vazio] = chaves[pos];
+            valores[vazio] = valores[pos];
+            vazio = pos;
         }
+        marcas[vazio] = 0;
+        quantidade--;
+        return true;
+    }
 
-        // Gerar novos estados
-        for (int i = 0; i < estadoAtual.size(); ++i)
-        {
-            vector<Capacidade> novoEstado = estadoAtual;
+    size_t size() const { return quantidade; }
+    size_t bytes() const { return marcas.capacity() * (1 + sizeof(ChaveEstado) + sizeof(Valor)); }
 
-            // Transferir água entre jarros
-            for (int j = 0; j < estadoAtual.size(); ++j)
-            {
-                if (i != j)
-                {
-                    novoEstado = estadoAtual;
-                    transferirAgua(novoEstado, i, j);
-                    if (!visitado.count(converterEstado(novoEstado)))
-                        fila.push({novoEstado, heuristica(novoEstado)});
-                }
-            }
-            // Encher jarro
-            encherJarro(novoEstado, i);
-            if (!visitado.count(converterEstado(novoEstado)))
-                fila.push({novoEstado, heuristica(novoEstado)});
+    // Esvazia a tabela mantendo a memória já alocada
+    void limpar()
+    {
+        fill(marcas.begin(), marcas.end(), 0);
+        quantidade = 0;
+    }
 
-            // Esvaziar jarro
-            novoEstado = estadoAtual;
-            esvaziarJarro(novoEstado, i);
-            if (!visitado.count(converterEstado(novoEstado)))
-                fila.push({novoEstado, heuristica(novoEstado)});
+    // Esvazia a tabela para reuso; se ela cresceu além de 'capacidadeMaxima'
+    // posições, volta ao tamanho inicial em vez de guardar a memória
+    void reiniciar(size_t capacidadeMaxima)
+    {
+        if (marcas.size() > capacidadeMaxima)
+            *this = TabelaChaves();
+        else
+            limpar();
+    }
 
+    // Percorre todos os pares (chave, valor) guardados
+    template <typename Funcao>
+    void paraCada(Funcao funcao) const
+    {
+        for (size_t pos = 0; pos < marcas.size(); ++pos)
+        {
+            if (marcas[pos] != 0)
+                funcao(chaves[pos], valores[pos]);
         }
     }
 
-    cout << "Nenhuma solucao encontrada." << endl;
-}
+private:
+    static constexpr size_t SEM_POSICAO = static_cast<size_t>(-1);
 
-// Função de Busca A*
-void buscaAEstrela(const vector<Capacidade> &jarros)
-{
-    cout << "Iniciando Busca A*..." << endl;
+    size_t quantidade = 0;
+    size_t mascara = 0;
+    vector<uint8_t> marcas;
+    vector<ChaveEstado> chaves;
+    vector<Valor> valores;
 
-    auto cmp = [](const pair<vector<Capacidade>, int> &a, const pair<vector<Capacidade>, int> &b)
+    static uint8_t marcaDe(uint64_t hash) { return static_cast<uint8_t>(0x80 | (hash >> 57)); }
+
+    size_t localizar(const ChaveEstado &chave, uint64_t hash) const
     {
-        return a.second > b.second; // Min-heap com base no custo acumulado + heurística
-    };
-    priority_queue<pair<vector<Capacidade>, int>, vector<pair<vector<Capacidade>, int>>, decltype(cmp)> fila(cmp);
-    set<vector<int>> visitado;
-    vector<vector<int>> caminho;
-    int nosVisitados = 0, nosExpandidos = 0;
+        uint8_t marca = marcaDe(hash);
+        for (size_t pos = hash & mascara;; pos = (pos + 1) & mascara)
+        {
+            if (marcas[pos] == 0)
+                return SEM_POSICAO;
+            if (marcas[pos] == marca && chaves[pos] == chave)
+                return pos;
+        }
+    }
 
-    fila.push({jarros, heuristica(jarros)});
+    void redimensionar(size_t novoTamanho)
+    {
+        vector<uint8_t> marcasAntigas(novoTamanho, 0);
+        vector<ChaveEstado> chavesAntigas(novoTamanho);
+        vector<Valor> valoresAntigos(novoTamanho);
+        marcasAntigas.swap(marcas);
+        chavesAntigas.swap(chaves);
+        valoresAntigos.swap(valores);
+        mascara = novoTamanho - 1;
 
-    auto start = high_resolution_clock::now();
+        for (size_t antigo = 0; antigo < marcasAntigas.size(); ++antigo)
+        {
+            if (marcasAntigas[antigo] == 0)
+                continue;
+            size_t pos = hashChave(chavesAntigas[antigo]) & mascara;
+            while (marcas[pos] != 0)
+                pos = (pos + 1) & mascara;
+            marcas[pos] = marcasAntigas[antigo];
+            chaves[pos] = chavesAntigas[antigo];
+            valores[pos] = valoresAntigos[antigo];
+        }
+    }
+};
 
-    while (!fila.empty())
+// Pool fixo de threads que executa a mesma tarefa em todas as threads e
+// espera o término (usado pelas buscas paralelas sincronizadas por nível)
+class PoolThreads
+{
+public:
+    explicit PoolThreads(int quantidade)
     {
-        auto [estadoAtual, custoHeuristicaAtual] = fila.top();
-        fila.pop();
+        for (int id = 0; id < quantidade; ++id)
+            threads.emplace_back([this, id]
+                                 { laco(id); });
+    }
 
-        vector<int> estado = converterEstado(estadoAtual);
+    ~PoolThreads()
+    {
+        {
+            lock_guard<mutex> guarda(trava);
+            encerrar = true;
+        }
+        inicio.notify_all();
+        for (auto &t : threads)
+            t.join();
+    }
 
-        if (visitado.count(estado))
-            continue;
+    int tamanho() const { return static_cast<int>(threads.size()); }
 
-        visitado.insert(estado);
-        caminho.push_back(estado);
-        nosExpandidos++;
+    // Executa tarefa(id) em cada thread do pool e retorna quando todas terminarem
+    void executar(const function<void(int)> &tarefa)
+    {
+        unique_lock<mutex> guarda(trava);
+        tarefaAtual = &tarefa;
+        pendentes = tamanho();
+        geracao++;
+        inicio.notify_all();
+        fim.wait(guarda, [this]
+                 { return pendentes == 0; });
+        tarefaAtual = nullptr;
+    }
 
-        if (todosAtingiramObjetivo(estadoAtual))
-        {
-            nosVisitados = visitado.size();
-            double fatorRamificacao = (nosVisitados > 1) ? static_cast<double>(nosExpandidos) / (nosVisitados - 1) : 0;
-            auto stop = high_resolution_clock::now();
-            auto duration = duration_cast<milliseconds>(stop - start).count();
-            exibirEstatisticas("A*", caminho, nosVisitados, nosExpandidos, fatorRamificacao, duration);
-            return;
-        }
+private:
+    vector<thread> threads;
+    mutex trava;
+    condition_variable inicio, fim;
+    const function<void(int)> *tarefaAtual = nullptr;
+    long long geracao = 0;
+    int pendentes = 0;
+    bool encerrar = false;
 
-        // Gerar novos estados
-        for (int i = 0; i < estadoAtual.size(); ++i)
+    void laco(int id)
+    {
+        long long vista = 0;
+        while (true)
         {
-            vector<Capacidade> novoEstado = estadoAtual;
-            // Transferir água entre jarros
-            for (int j = 0; j < estadoAtual.size(); ++j)
+            const function<void(int)> *tarefa;
             {
-                if (i != j)
-                {
-                    novoEstado = estadoAtual;
-                    transferirAgua(novoEstado, i, j);
-                    if (!visitado.count(converterEstado(novoEstado)))
-                        fila.push({novoEstado, custoHeuristicaAtual + 1 + heuristica(novoEstado)});
-                }
+                unique_lock<mutex> guarda(trava);
+                inicio.wait(guarda, [&]
+                            { return encerrar || geracao != vista; });
+                if (encerrar)
+                    return;
+                vista = geracao;
+                tarefa = tarefaAtual;
+            }
+            (*tarefa)(id);
+            {
+                lock_guard<mutex> guarda(trava);
+                if (--pendentes == 0)
+                    fim.notify_one();
             }
-            // Encher jarro
-            encherJarro(novoEstado, i);
-            if (!visitado.count(converterEstado(novoEstado)))
-                fila.push({novoEstado, custoHeuristicaAtual + 1 + heuristica(novoEstado)});
-
-            // Esvaziar jarro
-            novoEstado = estadoAtual;
-            esvaziarJarro(novoEstado, i);
-            if (!visitado.count(converterEstado(novoEstado)))
-                fila.push({novoEstado, custoHeuristicaAtual + 1 + heuristica(novoEstado)});
-
         }
     }
+};
 
-    cout << "Nenhuma solucao encontrada." << endl;
+// Número de threads a usar quando o usuário pede o valor automático (0)
+int threadsDisponiveis(int pedido)
+{
+    if (pedido > 0)
+        return pedido;
+    int hardware = static_cast<int>(thread::hardware_concurrency());
+    return hardware > 0 ? hardware : 1;
 }
 
-/*_____________MAIN___________*/
-int main()
+// Tabela concorrente dividida em fatias: cada fatia é uma TabelaChaves com
+// sua própria trava, escolhida por bits intermediários do hash (os baixos
+// definem a posição e os mais altos a marca dentro da fatia), então threads que
+// inserem estados diferentes raramente disputam a mesma trava
+template <typename Valor>
+class TabelaConcorrente
 {
-    int tam = 0;
-
-    cout << "Informe a quantidade de jarros: ";
-    cin >> tam;
-
-    vector<Capacidade> jarros(tam);
+public:
+    explicit TabelaConcorrente(int bitsFatias = 8) : fatias(static_cast<size_t>(1) << bitsFatias), mascaraFatia((static_cast<size_t>(1) << bitsFatias) - 1) {}
 
-    cout << "Informe o volume maximo dos jarros" << endl;
-    for (int i = 0; i < tam; ++i)
+    pair<Valor, bool> inserir(const ChaveEstado &chave, const Valor &valor)
     {
-        cout << "Jarros " << i + 1 << ": ";
-        cin >> jarros[i].capacidadeMax;
+        Fatia &fatia = fatias[(hashChave(chave) >> 40) & mascaraFatia];
+        lock_guard<mutex> guarda(fatia.trava);
+        auto [guardado, inseriu] = fatia.tabela.inserir(chave, valor);
+        return {*guardado, inseriu};
     }
 
-    cout << endl;
-
-    cout << "Informe o objetivo de cada jarro" << endl;
-    for (int i = 0; i < tam; ++i)
+    bool buscar(const ChaveEstado &chave, Valor &valor)
     {
-        cout << "Jarro " << i + 1 << ": ";
-        cin >> jarros[i].objetivo;
+        Fatia &fatia = fatias[(hashChave(chave) >> 40) & mascaraFatia];
+        lock_guard<mutex> guarda(fatia.trava);
+        const Valor *guardado = fatia.tabela.buscar(chave);
+        if (guardado)
+            valor = *guardado;
+        return guardado != nullptr;
     }
 
-    cout << "\nInforme a capacidade atual de cada jarro" << endl;
-    for (int i = 0; i < tam; ++i)
+    // Insere a chave ou, se ela já existe, troca o valor guardado quando
+    // melhor(novo, guardado); retorna se o valor foi gravado
+    template <typename Melhor>
+    bool inserirOuMelhorar(const ChaveEstado &chave, const Valor &valor, Melhor melhor)
     {
-        cout << "Jarro " << i + 1 << ": ";
-        cin >> jarros[i].capacidadeAtual;
+        Fatia &fatia = fatias[(hashChave(chave) >> 40) & mascaraFatia];
+        lock_guard<mutex> guarda(fatia.trava);
+        auto [guardado, inseriu] = fatia.tabela.inserir(chave, valor);
+        if (inseriu)
+            return true;
+        if (!melhor(valor, *guardado))
+            return false;
+        *guardado = valor;
+        return true;
     }
-    /*
-        // Executar as buscas
 
-        vector<Capacidade> jarros =
-        {
-        {0, 4, 0}, // Jarro 1: capacidade atual = 0, capacidade máxima = 4, objetivo = 0
-        {0, 3, 2}, // Jarro 2: capacidade atual = 0, capacidade máxima = 3, objetivo = 2
-        {0, 9, 0}  // Jarro 3: capacidade atual = 0, capacidade máxima = 9, objetivo = 0
-        };
-    */
-    char opcao = 0;
-    cout << endl;
-    while (true)
+    size_t size()
+    {
+        size_t total = 0;
+        for (auto &fatia : fatias)
+        {
+            lock_guard<mutex> guarda(fatia.trava);
+            total += fatia.tabela.size();
+        }
+        return total;
+    }
+
+private:
+    struct alignas(64) Fatia
+    {
+        mutex trava;
+        TabelaChaves<Valor> tabela{64};
+    };
+    vector<Fatia> fatias;
+    size_t mascaraFatia;
+};
+
+// Função de heurística para Busca Gulosa
+int heuristica(const Instancia &inst, const int *niveis)
+{
+    int heuristica = 0;
+    for (int i = 0; i < inst.n; ++i)
+    {
+        heuristica += abs(niveis[i] - inst.objetivo[i]);
+    }
+    return heuristica;
+}
+
+// Implementações da lista aberta das buscas com custo
+enum TipoListaAberta
+{
+    LISTA_HEAP,        // priority_queue binária, O(log n) por operação
+    LISTA_BALDES_FIFO, // baldes por prioridade (Dial), empates em ordem de chegada
+    LISTA_BALDES_LIFO  // baldes por prioridade (Dial), empates do mais recente
+};
+
+// Heurísticas disponíveis para as buscas informadas
+enum TipoHeuristica
+{
+    HEURISTICA_SOMA,   // soma de |capacidadeAtual - objetivo| (não admissível)
+    HEURISTICA_PADROES // banco de padrões (admissível)
+};
+
+// Configurações escolhidas no menu e usadas pelas buscas
+struct ConfiguracaoBusca
+{
+    TipoListaAberta listaAberta = LISTA_HEAP;
+    TipoHeuristica heuristica = HEURISTICA_PADROES;
+    int profundidadeMaximaBacktracking = 0; // 0 = sem limite
+    bool simetria = true;                   // jarros intercambiáveis (ver GeradorSucessores)
+    long long intervaloAmostrasMs = 0;      // amostras periódicas das métricas; 0 = desligadas
+    bool resolvedoresEspecializados = true; // ResolvedorFixo para 2 a 8 jarros
+    bool expansaoParcial = false;           // UCS, Gulosa e A* com expansão parcial
+    string algoritmosPortfolio = "dfs,gulosa,bfs,astar"; // participantes, "nome[:limite de nos]"
+    bool portfolioOtimo = false;            // aceita só soluções com otimalidade garantida
+    int corredoresPortfolio = 0;            // participantes ao mesmo tempo; 0 = todos
+    double pesoInicialAnytime = 3.0;        // peso da heurística na primeira iteração do ARA*
+    double reducaoPesoAnytime = 0.5;        // redução do peso a cada iteração
+    size_t orcamentoCacheRetrogrado = static_cast<size_t>(64) << 20; // bytes das tabelas retrógradas
+    size_t orcamentoBancoPadroes = static_cast<size_t>(64) << 20;    // bytes dos bancos de padrões
+    size_t memoriaBfsExterna = static_cast<size_t>(64) << 20;        // buffers da BFS em disco
+    size_t memoriaBfsDensa = static_cast<size_t>(256) << 20;         // mapas de 2 bits da BFS densa (só ela usa)
+    string diretorioBfsExterna;                                       // vazio = diretório temporário
+};
+
+ConfiguracaoBusca configuracao;
+
+// Fila de prioridade em baldes para prioridades inteiras pequenas e não
+// negativas: cada prioridade tem seu balde e um cursor aponta para o menor
+// balde não vazio, então inserir e retirar custam O(1) amortizado
+class FilaBaldes
+{
+public:
+    // Prioridades a partir daqui não cabem nos baldes (o vetor de baldes
+    // cresceria com o valor da prioridade); quem usa a fila passa para o heap
+    static constexpr int LIMITE_PRIORIDADE = 1 << 16;
+
+    explicit FilaBaldes(bool lifo) : lifo(lifo) {}
+
+    void inserir(int prioridade, int valor)
+    {
+        size_t p = static_cast<size_t>(prioridade);
+        if (p >= baldes.size())
+            baldes.resize(p + 1);
+        baldes[p].itens.push_back(valor);
+        if (p < atual)
+            atual = p;
+        quantidade++;
+    }
+
+    // Retira um valor de menor prioridade; a fila não pode estar vazia
+    int retirar()
+    {
+        while (baldes[atual].itens.size() == baldes[atual].inicio)
+            atual++;
+        Balde &balde = baldes[atual];
+        int valor;
+        if (lifo)
+        {
+            valor = balde.itens.back();
+            balde.itens.pop_back();
+        }
+        else
+        {
+            valor = balde.itens[balde.inicio++];
+        }
+        if (balde.itens.size() == balde.inicio)
+        {
+            balde.itens.clear();
+            balde.inicio = 0;
+        }
+        quantidade--;
+        return valor;
+    }
+
+    bool vazia() const { return quantidade == 0; }
+    size_t size() const { return quantidade; }
+
+    // Move todos os pares {prioridade, valor} para 'destino' e esvazia a fila
+    void transferir(vector<pair<int, int>> &destino)
+    {
+        for (size_t p = atual; p < baldes.size(); ++p)
+        {
+            for (size_t k = baldes[p].inicio; k < baldes[p].itens.size(); ++k)
+                destino.push_back({static_cast<int>(p), baldes[p].itens[k]});
+        }
+        limpar();
+    }
+
+    // Esvazia a fila mantendo os baldes já alocados
+    void limpar()
+    {
+        for (auto &balde : baldes)
+        {
+            balde.itens.clear();
+            balde.inicio = 0;
+        }
+        atual = 0;
+        quantidade = 0;
+    }
+
+private:
+    struct Balde
+    {
+        vector<int> itens;
+        size_t inicio = 0; // próximo item a sair no modo FIFO
+    };
+    vector<Balde> baldes;
+    size_t atual = 0;
+    size_t quantidade = 0;
+    bool lifo;
+};
+
+// Lista aberta das buscas com custo: guarda índices de nós da arena e usa o
+// heap ou os baldes conforme o tipo escolhido, para comparar os dois. Uma
+// prioridade acima de FilaBaldes::LIMITE_PRIORIDADE (a soma das diferenças
+// com capacidades grandes) passa os baldes para o heap até a próxima busca.
+class ListaAberta
+{
+public:
+    explicit ListaAberta(TipoListaAberta tipo) : tipo(tipo), usarHeap(tipo == LISTA_HEAP), baldes(tipo == LISTA_BALDES_LIFO) {}
+
+    void inserir(int prioridade, int indice)
+    {
+        if (!usarHeap && prioridade >= FilaBaldes::LIMITE_PRIORIDADE)
+        {
+            baldes.transferir(heap);
+            make_heap(heap.begin(), heap.end(), greater<pair<int, int>>());
+            usarHeap = true;
+        }
+        if (usarHeap)
+        {
+            heap.push_back({prioridade, indice});
+            push_heap(heap.begin(), heap.end(), greater<pair<int, int>>());
+        }
+        else
+        {
+            baldes.inserir(prioridade, indice);
+        }
+    }
+
+    int retirar()
+    {
+        if (!usarHeap)
+            return baldes.retirar();
+        pop_heap(heap.begin(), heap.end(), greater<pair<int, int>>());
+        int indice = heap.back().second;
+        heap.pop_back();
+        return indice;
+    }
+
+    bool vazia() const { return usarHeap ? heap.empty() : baldes.vazia(); }
+    size_t size() const { return usarHeap ? heap.size() : baldes.size(); }
+
+    // Esvazia a lista (podendo trocar o tipo) sem devolver a memória do heap
+    // nem a dos baldes, para reaproveitá-la na próxima busca
+    void limpar(TipoListaAberta novoTipo)
+    {
+        heap.clear();
+        baldes.limpar();
+        if (novoTipo != tipo)
+        {
+            tipo = novoTipo;
+            baldes = FilaBaldes(tipo == LISTA_BALDES_LIFO);
+        }
+        usarHeap = tipo == LISTA_HEAP;
+    }
+
+private:
+    TipoListaAberta tipo;
+    bool usarHeap; // o tipo é heap ou os baldes transbordaram
+    // Min-heap de pares {prioridade, índice do nó}, mantido com push_heap e
+    // pop_heap sobre um vector para poder ser esvaziado sem desalocar
+    vector<pair<int, int>> heap;
+    FilaBaldes baldes;
+};
+
+const char *nomeListaAberta(TipoListaAberta tipo)
+{
+    switch (tipo)
+    {
+    case LISTA_HEAP:
+        return "heap binario";
+    case LISTA_BALDES_FIFO:
+        return "baldes (FIFO)";
+    default:
+        return "baldes (LIFO)";
+    }
+}
+
+// Controle de parada cooperativa das buscas: prazo, orçamento de nós e sinal de cancelamento
+struct ControleBusca
+{
+    high_resolution_clock::time_point prazo = high_resolution_clock::time_point::max();
+    const atomic<bool> *cancelar = nullptr;
+    long long limiteNos = 0; // nós expandidos por busca; 0 = sem limite
+
+    bool deveParar() const
+    {
+        return (cancelar && cancelar->load(memory_order_relaxed)) || high_resolution_clock::now() >= prazo;
+    }
+};
+
+// Controle da busca em andamento nesta thread (nulo = sem limites). As buscas
+// paralelas copiam o ponteiro para as suas threads de trabalho.
+thread_local const ControleBusca *controleAtual = nullptr;
+
+// Instala um controle na thread enquanto o escopo existir
+class EscopoControle
+{
+public:
+    explicit EscopoControle(const ControleBusca *controle) : anterior(controleAtual) { controleAtual = controle; }
+    ~EscopoControle() { controleAtual = anterior; }
+
+private:
+    const ControleBusca *anterior;
+};
+
+// Consultada pelas buscas antes de cada expansão. 'iteracoes' conta as voltas
+// do laço (o relógio só é lido a cada 1024) e 'expandidos' só as expansões
+// já feitas, de modo que a busca para com exatamente limiteNos expansões.
+inline bool deveInterromper(const ControleBusca *controle, long long iteracoes, long long expandidos)
+{
+    return controle && (((iteracoes & 1023) == 0 && controle->deveParar()) ||
+                        (controle->limiteNos > 0 && expandidos >= controle->limiteNos));
+}
+
+// Valor da heurística para estados que não alcançam o objetivo
+const int HEURISTICA_INFINITA = numeric_limits<int>::max() / 4;
+
+// Projeção da instância sobre um subconjunto de jarros, com a distância exata
+// de cada estado projetado até o objetivo projetado
+struct PadraoJarros
+{
+    vector<int> jarros;          // índices dos jarros do padrão
+    vector<size_t> pesos;        // peso de cada jarro no índice de base mista
+    vector<uint16_t> distancias; // indexado pelo estado projetado
+};
+
+// Banco de padrões (pattern database): os jarros são divididos em grupos
+// disjuntos de espaço projetado pequeno e, para cada grupo, uma BFS reversa a
+// partir do objetivo calcula a distância exata no espaço projetado.
+//
+// Jarros fora do padrão são abstraídos: uma transferência com um deles vira
+// "o nível muda em até maiorFora unidades". Assim cada movimento real é um
+// movimento (ou nada) em cada projeção e cada distância projetada é uma cota
+// inferior. Como um movimento real altera no máximo dois jarros, ele reduz a
+// soma das distâncias de no máximo 2; por isso max(maior distância,
+// teto(soma / 2)) continua admissível.
+//
+// A construção custa O(estados projetados × maior capacidade fora do padrão)
+// e consulta o 'controle' durante as BFS; se ele mandar parar, o banco fica
+// incompleto e não deve ser usado. Jarros com mais valores que 'limiteEstados'
+// e grupos cuja BFS passaria de 'limiteTrabalho' passos ficam sem padrão: com
+// menos padrões o máximo e a metade da soma continuam cotas inferiores.
+class BancoPadroes
+{
+public:
+    static constexpr uint16_t INALCANCAVEL = numeric_limits<uint16_t>::max();
+
+    BancoPadroes(const Instancia &inst, const ControleBusca *controle = nullptr,
+                 size_t limiteEstados = static_cast<size_t>(1) << 20,
+                 size_t limiteTrabalho = static_cast<size_t>(1) << 26)
+        : controle(controle), limiteTrabalho(limiteTrabalho)
+    {
+        auto inicio = high_resolution_clock::now();
+        for (const auto &grupo : agrupar(inst, limiteEstados))
+        {
+            if (!adicionarPadrao(inst, grupo))
+                return;
+        }
+        completo = true;
+        tempoConstrucaoMicros = duration_cast<microseconds>(high_resolution_clock::now() - inicio).count();
+    }
+
+    int avaliar(const int *niveis) const
+    {
+        int maior = 0, soma = 0;
+        for (const auto &padrao : padroes)
+        {
+            size_t indice = 0;
+            for (size_t k = 0; k < padrao.jarros.size(); ++k)
+                indice += static_cast<size_t>(niveis[padrao.jarros[k]]) * padrao.pesos[k];
+            uint16_t distancia = padrao.distancias[indice];
+            if (distancia == INALCANCAVEL)
+                return HEURISTICA_INFINITA;
+            maior = max(maior, static_cast<int>(distancia));
+            soma += distancia;
+        }
+        return max(maior, (soma + 1) / 2);
+    }
+
+    size_t numeroPadroes() const { return padroes.size(); }
+
+    // Cota superior dos bytes do banco, sem construí-lo
+    static size_t bytesPrevistos(const Instancia &inst, size_t limiteEstados = static_cast<size_t>(1) << 20)
+    {
+        size_t total = 0;
+        for (const auto &grupo : agrupar(inst, limiteEstados))
+        {
+            size_t estados = 1;
+            for (int jarro : grupo)
+                estados *= static_cast<size_t>(inst.capacidadeMax[jarro]) + 1;
+            total += estados * sizeof(uint16_t);
+        }
+        return total;
+    }
+
+    // Falso se a construção foi interrompida pelo controle
+    bool construido() const { return completo; }
+
+    // Índice do padrão que contém o jarro
+    int padraoDoJarro(int jarro) const
+    {
+        for (size_t p = 0; p < padroes.size(); ++p)
+        {
+            if (find(padroes[p].jarros.begin(), padroes[p].jarros.end(), jarro) != padroes[p].jarros.end())
+                return static_cast<int>(p);
+        }
+        return -1;
+    }
+    long long tempoConstrucao() const { return tempoConstrucaoMicros; }
+
+    size_t bytes() const
+    {
+        size_t total = 0;
+        for (const auto &padrao : padroes)
+            total += padrao.distancias.size() * sizeof(uint16_t);
+        return total;
+    }
+
+private:
+    vector<PadraoJarros> padroes;
+    const ControleBusca *controle;
+    size_t limiteTrabalho;
+    bool completo = false;
+    long long tempoConstrucaoMicros = 0;
+
+    // Agrupa jarros consecutivos enquanto o espaço projetado couber no limite
+    static vector<vector<int>> agrupar(const Instancia &inst, size_t limiteEstados)
+    {
+        vector<vector<int>> grupos;
+        vector<int> grupo;
+        size_t tamanhoGrupo = 1;
+        for (int i = 0; i < inst.n; ++i)
+        {
+            size_t valores = static_cast<size_t>(inst.capacidadeMax[i]) + 1;
+            if (valores > limiteEstados)
+                continue; // sozinho já não caberia: o jarro fica sem padrão
+            if (!grupo.empty() && tamanhoGrupo * valores > limiteEstados)
+            {
+                grupos.push_back(move(grupo));
+                grupo.clear();
+                tamanhoGrupo = 1;
+            }
+            grupo.push_back(i);
+            tamanhoGrupo *= valores;
+        }
+        if (!grupo.empty())
+            grupos.push_back(move(grupo));
+        return grupos;
+    }
+
+    // Retorna falso se o controle interromper a BFS do padrão; um grupo caro
+    // demais é descartado sem erro
+    bool adicionarPadrao(const Instancia &inst, const vector<int> &grupo)
+    {
+        PadraoJarros padrao;
+        padrao.jarros = grupo;
+        size_t total = 1;
+        int maiorDentro = 0;
+        for (int jarro : grupo)
+        {
+            padrao.pesos.push_back(total);
+            total *= static_cast<size_t>(inst.capacidadeMax[jarro]) + 1;
+            maiorDentro = max(maiorDentro, inst.capacidadeMax[jarro]);
+        }
+
+        // Maior capacidade entre os jarros fora do padrão (0 se não houver)
+        int maiorFora = 0;
+        for (int i = 0; i < inst.n; ++i)
+        {
+            if (find(grupo.begin(), grupo.end(), i) == grupo.end())
+                maiorFora = max(maiorFora, inst.capacidadeMax[i]);
+        }
+
+        // Cada estado tenta até 2 × min(maiorFora, maiorDentro) transferências
+        // com jarros de fora
+        size_t passos = static_cast<size_t>(min(maiorFora, maiorDentro)) * 2 + 1;
+        if (passos > limiteTrabalho / total)
+            return true;
+        padrao.distancias.assign(total, INALCANCAVEL);
+
+        int k = static_cast<int>(grupo.size());
+        vector<int> capacidades(k), niveis(k);
+        size_t objetivo = 0;
+        bool objetivoValido = true;
+        for (int a = 0; a < k; ++a)
+        {
+            capacidades[a] = inst.capacidadeMax[grupo[a]];
+            int alvo = inst.objetivo[grupo[a]];
+            objetivoValido = objetivoValido && alvo >= 0 && alvo <= capacidades[a];
+            objetivo += static_cast<size_t>(max(alvo, 0)) * padrao.pesos[a];
+        }
+        if (!objetivoValido)
+        {
+            padroes.push_back(move(padrao));
+            return true;
+        }
+
+        // BFS reversa no espaço projetado: percorre os predecessores de cada
+        // estado. Cada um pode visitar O(maiorFora) vizinhos, então o relógio
+        // é lido a cada 64 estados e não a cada 1024.
+        vector<uint32_t> fila;
+        fila.push_back(static_cast<uint32_t>(objetivo));
+        padrao.distancias[objetivo] = 0;
+        for (size_t frente = 0; frente < fila.size(); ++frente)
+        {
+            if (controle && (frente & 63) == 0 && controle->deveParar())
+                return false;
+            size_t indice = fila[frente];
+            uint16_t proxima = static_cast<uint16_t>(padrao.distancias[indice] + 1);
+            size_t resto = indice;
+            for (int a = k - 1; a >= 0; --a)
+            {
+                niveis[a] = static_cast<int>(resto / padrao.pesos[a]);
+                resto %= padrao.pesos[a];
+            }
+
+            auto visitar = [&](int a, int valorA, int b, int valorB)
+            {
+                size_t anterior = indice + (valorA - niveis[a]) * padrao.pesos[a];
+                if (b != a)
+                    anterior += (valorB - niveis[b]) * padrao.pesos[b];
+                if (padrao.distancias[anterior] == INALCANCAVEL)
+                {
+                    padrao.distancias[anterior] = proxima;
+                    fila.push_back(static_cast<uint32_t>(anterior));
+                }
+            };
+
+            for (int a = 0; a < k; ++a)
+            {
+                if (niveis[a] == capacidades[a])
+                {
+                    for (int v = 0; v < capacidades[a]; ++v)
+                        visitar(a, v, a, v); // encher
+                }
+                if (niveis[a] == 0)
+                {
+                    for (int v = 1; v <= capacidades[a]; ++v)
+                        visitar(a, v, a, v); // esvaziar
+                }
+                // Transferências com jarros fora do padrão, nos dois sentidos
+                for (int q = 1; q <= maiorFora && niveis[a] + q <= capacidades[a]; ++q)
+                    visitar(a, niveis[a] + q, a, niveis[a] + q);
+                for (int q = 1; q <= maiorFora && niveis[a] - q >= 0; ++q)
+                    visitar(a, niveis[a] - q, a, niveis[a] - q);
+                // Transferências dentro do padrão (como em gerarPredecessores)
+                for (int b = 0; b < k; ++b)
+                {
+                    if (a == b || (niveis[a] != 0 && niveis[b] != capacidades[b]))
+                        continue;
+                    int maximo = min(niveis[b], capacidades[a] - niveis[a]);
+                    for (int q = 1; q <= maximo; ++q)
+                        visitar(a, niveis[a] + q, b, niveis[b] - q);
+                }
+            }
+        }
+        padroes.push_back(move(padrao));
+        return true;
+    }
+};
+
+// Cache de bancos de padrões por par (capacidades, objetivos), com descarte
+// do item usado há mais tempo (LRU) quando a soma dos bancos passa do
+// orçamento; o banco mais recente sempre fica, mesmo sozinho acima dele.
+// Quem ainda usa um banco descartado o mantém vivo pelo shared_ptr.
+class CacheBancoPadroes
+{
+public:
+    // Retorna o banco do par, construindo-o se preciso; nulo se o 'controle'
+    // mandar parar antes de o banco ficar pronto
+    shared_ptr<const BancoPadroes> obter(const Instancia &inst, const ControleBusca *controle)
+    {
+        Chave chave = {inst.capacidadeMax, inst.objetivo};
+        unique_lock<mutex> guarda(trava);
+        while (true)
+        {
+            auto it = indices.find(chave);
+            if (it != indices.end())
+            {
+                entradas.splice(entradas.begin(), entradas, it->second); // mais recente
+                return it->second->second;
+            }
+            if (!emConstrucao.count(chave))
+                break;
+            // Outra thread constrói o mesmo banco: espera por ele em vez de
+            // construí-lo de novo, sem passar do próprio prazo
+            if (controle && controle->deveParar())
+                return nullptr;
+            construcaoTerminada.wait_for(guarda, milliseconds(10));
+        }
+
+        // Constrói fora da trava para não bloquear as buscas de outras instâncias
+        emConstrucao.insert(chave);
+        guarda.unlock();
+        shared_ptr<const BancoPadroes> banco;
+        try
+        {
+            banco = make_shared<const BancoPadroes>(inst, controle);
+        }
+        catch (...)
+        {
+            guarda.lock();
+            emConstrucao.erase(chave);
+            construcaoTerminada.notify_all();
+            throw;
+        }
+        guarda.lock();
+        emConstrucao.erase(chave);
+        construcaoTerminada.notify_all();
+        if (!banco->construido())
+            return nullptr;
+
+        entradas.emplace_front(chave, banco);
+        indices[chave] = entradas.begin();
+        bytesUsados += banco->bytes();
+        while (bytesUsados > configuracao.orcamentoBancoPadroes && entradas.size() > 1)
+        {
+            bytesUsados -= entradas.back().second->bytes();
+            indices.erase(entradas.back().first);
+            entradas.pop_back();
+        }
+        return banco;
+    }
+
+private:
+    using Chave = pair<vector<int>, vector<int>>;
+    using Entrada = pair<Chave, shared_ptr<const BancoPadroes>>;
+
+    mutex trava;
+    condition_variable construcaoTerminada; // avisado quando uma construção termina
+    list<Entrada> entradas; // do usado mais recentemente para o mais antigo
+    map<Chave, list<Entrada>::iterator> indices;
+    set<Chave> emConstrucao;
+    size_t bytesUsados = 0;
+};
+
+CacheBancoPadroes cacheBancoPadroes;
+
+// Obtém o banco de padrões da instância, construindo-o apenas na primeira
+// vez em que um par (capacidades, objetivos) aparece (ou depois de descartado).
+// Nulo se a busca desta thread for interrompida antes de o banco ficar pronto.
+shared_ptr<const BancoPadroes> obterBancoPadroes(const Instancia &inst)
+{
+    return cacheBancoPadroes.obter(inst, controleAtual);
+}
+
+// Heurística usada pelas buscas informadas, conforme a configuração
+class Heuristica
+{
+public:
+    // Com 'ativa' falso a heurística vale sempre 0 (buscas não informadas);
+    // com 'permitirPadroes' falso usa sempre a soma das diferenças (Gulosa);
+    // um banco que passaria de 'limiteBytesPadroes' também dá lugar à soma
+    explicit Heuristica(const Instancia &inst, bool ativa = true, bool permitirPadroes = true,
+                        size_t limiteBytesPadroes = numeric_limits<size_t>::max())
+        : inst(inst), ativa(ativa)
+    {
+        if (ativa && permitirPadroes && configuracao.heuristica == HEURISTICA_PADROES &&
+            BancoPadroes::bytesPrevistos(inst) <= limiteBytesPadroes)
+            banco = obterBancoPadroes(inst);
+    }
+
+    int operator()(const int *niveis) const
+    {
+        if (!ativa)
+            return 0;
+        return banco ? banco->avaliar(niveis) : heuristica(inst, niveis);
+    }
+
+    // Indica se a heurística é admissível (garante soluções ótimas no A*)
+    bool admissivel() const { return banco != nullptr; }
+
+    // Indica se o valor é a soma das diferenças (atualizável por movimento)
+    bool usaSoma() const { return ativa && !banco; }
+
+    // Indica se o valor não muda ao permutar jarros da mesma classe (mesma
+    // capacidade e objetivo). A soma das diferenças sempre é; o banco de
+    // padrões só é se cada classe estiver inteira dentro de um padrão.
+    bool simetrica(const vector<int> &classeJarro) const
+    {
+        if (!ativa || !banco)
+            return true;
+        for (int i = 0; i < inst.n; ++i)
+        {
+            for (int j = i + 1; j < inst.n; ++j)
+            {
+                if (classeJarro[i] == classeJarro[j] && banco->padraoDoJarro(i) != banco->padraoDoJarro(j))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    const Instancia &inst;
+    bool ativa;
+    shared_ptr<const BancoPadroes> banco;
+};
+
+// Dados de um nó da busca; os níveis dos jarros ficam guardados na arena
+struct No
+{
+    int pai = -1; // índice do nó pai na arena (-1 na raiz)
+    int g = 0;    // custo acumulado desde o estado inicial
+    int h = 0;    // valor da heurística
+};
+
+// Arena de nós: os níveis de todos os nós ficam em um único vetor contíguo
+// (n inteiros por nó) e as filas das buscas guardam apenas índices
+class ArenaNos
+{
+public:
+    explicit ArenaNos(int n) : n(n) {}
+
+    // Cria um nó copiando os níveis; 'niveisNo' não pode apontar para dentro da arena
+    int criar(const int *niveisNo, int pai, int g, int h)
+    {
+        niveisNos.insert(niveisNos.end(), niveisNo, niveisNo + n);
+        nos.push_back({pai, g, h});
+        return static_cast<int>(nos.size()) - 1;
+    }
+
+    const int *niveis(int indice) const { return &niveisNos[static_cast<size_t>(indice) * n]; }
+    const No &no(int indice) const { return nos[indice]; }
+    int size() const { return static_cast<int>(nos.size()); }
+
+    // Troca o pai e o custo de um nó já criado, quando a busca acha um caminho melhor até ele
+    void reparentar(int indice, int pai, int g)
+    {
+        nos[indice].pai = pai;
+        nos[indice].g = g;
+    }
+    size_t bytes() const { return niveisNos.capacity() * sizeof(int) + nos.capacity() * sizeof(No); }
+
+    // Reconstrói o caminho da raiz até o nó seguindo os ponteiros para o pai
+    vector<vector<int>> caminhoAte(int indice) const
+    {
+        vector<vector<int>> caminho;
+        for (int atual = indice; atual != -1; atual = nos[atual].pai)
+            caminho.emplace_back(niveis(atual), niveis(atual) + n);
+        reverse(caminho.begin(), caminho.end());
+        return caminho;
+    }
+
+private:
+    int n;
+    vector<int> niveisNos;
+    vector<No> nos;
+};
+
+// Métricas comuns a todas as buscas. As buscas instrumentadas preenchem todos
+// os campos por meio de MonitorBusca; as demais apenas os totais.
+struct MetricasBusca
+{
+    bool instrumentada = false;
+    long long gerados = 0;    // sucessores produzidos pelos movimentos
+    long long duplicados = 0; // sucessores rejeitados por já terem sido visitados
+    long long expandidos = 0;
+    long long reabertos = 0;  // estados expandidos mais de uma vez
+    size_t maiorAberta = 0;   // maior tamanho da lista aberta (fila, pilha ou heap)
+    size_t maiorVisitados = 0;
+    size_t bytes = 0; // estimativa da memória das estruturas da busca
+    // Tempo estimado de cada fase (-1 = não medido); a geração inclui o
+    // restante da expansão, fora a consulta aos visitados e a lista aberta
+    long long nanosGeracao = -1, nanosConsulta = -1, nanosFila = -1;
+};
+
+enum FaseBusca
+{
+    FASE_EXPANSAO,
+    FASE_CONSULTA,
+    FASE_FILA,
+    TOTAL_FASES
+};
+
+// Coleta as métricas de uma busca. Os contadores são incrementos simples; o
+// relógio só é lido nas expansões amostradas (1 a cada PERIODO_FASES) para
+// estimar o tempo das fases e, a cada 1024 expansões, para decidir se uma
+// amostra periódica deve ser emitida (configuracao.intervaloAmostrasMs).
+class MonitorBusca
+{
+public:
+    static constexpr long long PERIODO_FASES = 64;
+
+    explicit MonitorBusca(const string &metodo) : metodo(metodo), inicio(high_resolution_clock::now())
+    {
+        metricas.instrumentada = true;
+        intervalo = milliseconds(configuracao.intervaloAmostrasMs);
+        proximaAmostra = inicio + intervalo;
+        custoRelogio(); // calibra antes da busca, fora de qualquer fase medida
+    }
+
+    void gerado() { metricas.gerados++; }
+    void duplicado(long long quantidade = 1) { metricas.duplicados += quantidade; }
+    void reaberto() { metricas.reabertos++; }
+
+    // Registra uma expansão com os tamanhos atuais da lista aberta e dos visitados
+    void expandido(size_t aberta, size_t visitados)
+    {
+        metricas.expandidos++;
+        metricas.maiorAberta = max(metricas.maiorAberta, aberta);
+        metricas.maiorVisitados = max(metricas.maiorVisitados, visitados);
+        cronometrando = metricas.expandidos % PERIODO_FASES == 0;
+        if (cronometrando)
+            expansoesCronometradas++;
+        if (intervalo.count() > 0 && (metricas.expandidos & 1023) == 0 && high_resolution_clock::now() >= proximaAmostra)
+            emitirAmostra();
+    }
+
+    size_t maiorAberta() const { return metricas.maiorAberta; }
+
+    // Indica se a expansão atual é uma das amostradas para o tempo das fases
+    bool medindoFases() const { return cronometrando; }
+
+    // Desconta a leitura do relógio contida em cada medição
+    void acumular(FaseBusca fase, long long nanos)
+    {
+        nanosFases[fase] += max(0LL, nanos - custoRelogio());
+        medicoesFases[fase]++;
+    }
+
+    // Métricas finais; os tempos das fases são extrapolados das expansões amostradas
+    MetricasBusca finalizar(size_t bytes)
+    {
+        metricas.bytes = bytes;
+        if (medicoesFases[FASE_EXPANSAO] > 0)
+        {
+            double escala = static_cast<double>(metricas.expandidos) / expansoesCronometradas;
+            // As medições internas também leram o relógio duas vezes dentro da expansão
+            long long internas = medicoesFases[FASE_CONSULTA] + medicoesFases[FASE_FILA];
+            long long expansao = max(0LL, nanosFases[FASE_EXPANSAO] - 2 * internas * custoRelogio());
+            metricas.nanosConsulta = static_cast<long long>(nanosFases[FASE_CONSULTA] * escala);
+            metricas.nanosFila = static_cast<long long>(nanosFases[FASE_FILA] * escala);
+            metricas.nanosGeracao = max(0LL, static_cast<long long>(expansao * escala) - metricas.nanosConsulta - metricas.nanosFila);
+        }
+        return metricas;
+    }
+
+private:
+    string metodo;
+    MetricasBusca metricas;
+    high_resolution_clock::time_point inicio, proximaAmostra;
+    milliseconds intervalo;
+    bool cronometrando = false;
+    long long expansoesCronometradas = 0;
+    long long nanosFases[TOTAL_FASES] = {0, 0, 0};
+    long long medicoesFases[TOTAL_FASES] = {0, 0, 0};
+
+    // Custo de uma leitura do relógio, medido uma única vez por execução
+    static long long custoRelogio()
+    {
+        static const long long custo = []
+        {
+            const int leituras = 1000;
+            auto inicio = high_resolution_clock::now();
+            for (int k = 0; k < leituras - 1; ++k)
+                high_resolution_clock::now();
+            return duration_cast<nanoseconds>(high_resolution_clock::now() - inicio).count() / leituras;
+        }();
+        return custo;
+    }
+
+    // Amostra periódica em uma linha JSON na saída de erro
+    void emitirAmostra()
+    {
+        auto agora = high_resolution_clock::now();
+        proximaAmostra = agora + intervalo;
+        double segundos = duration_cast<microseconds>(agora - inicio).count() / 1e6;
+        cerr << "{\"amostra\":\"" << metodo << "\",\"tempo_ms\":" << static_cast<long long>(segundos * 1000)
+             << ",\"expandidos\":" << metricas.expandidos << ",\"gerados\":" << metricas.gerados
+             << ",\"duplicados\":" << metricas.duplicados << ",\"maior_aberta\":" << metricas.maiorAberta
+             << ",\"visitados\":" << metricas.maiorVisitados
+             << ",\"nos_por_segundo\":" << static_cast<long long>(metricas.expandidos / max(segundos, 1e-6)) << "}" << endl;
+    }
+};
+
+// Mede o tempo de uma fase enquanto existir, apenas nas expansões amostradas
+class MedidorFase
+{
+public:
+    MedidorFase(MonitorBusca &monitor, FaseBusca fase) : monitor(monitor), fase(fase), ativo(monitor.medindoFases())
+    {
+        if (ativo)
+            inicio = high_resolution_clock::now();
+    }
+
+    ~MedidorFase()
+    {
+        if (ativo)
+            monitor.acumular(fase, duration_cast<nanoseconds>(high_resolution_clock::now() - inicio).count());
+    }
+
+private:
+    MonitorBusca &monitor;
+    FaseBusca fase;
+    bool ativo;
+    high_resolution_clock::time_point inicio;
+};
+
+// Resultado de uma busca, exibido depois por exibirEstatisticas
+struct ResultadoBusca
+{
+    string metodo;
+    bool encontrou = false;
+    bool interrompida = false; // parou por prazo ou cancelamento
+    vector<vector<int>> caminho; // estados do inicial ao objetivo
+    int custo = 0;
+    int nosVisitados = 0;
+    int nosExpandidos = 0;
+    long long tempoMicros = 0;
+    int threads = 1;
+    MetricasBusca metricas;
+    double limiteSubotimalidade = 0;       // custo <= limite * ótimo (buscas anytime; 0 = não se aplica)
+    vector<pair<string, string>> detalhes; // estatísticas próprias de cada método
+};
+
+ResultadoBusca montarResultado(const string &metodo, const ArenaNos &arena, int noObjetivo, size_t nosVisitados, int nosExpandidos, high_resolution_clock::time_point inicio, bool interrompida = false)
+{
+    ResultadoBusca resultado;
+    resultado.tempoMicros = duration_cast<microseconds>(high_resolution_clock::now() - inicio).count();
+    resultado.metodo = metodo;
+    resultado.interrompida = interrompida;
+    resultado.nosVisitados = static_cast<int>(nosVisitados);
+    resultado.nosExpandidos = nosExpandidos;
+    resultado.metricas.expandidos = nosExpandidos;
+    resultado.metricas.maiorVisitados = nosVisitados;
+    if (noObjetivo != -1)
+    {
+        resultado.encontrou = true;
+        resultado.caminho = arena.caminhoAte(noObjetivo);
+        resultado.custo = arena.no(noObjetivo).g;
+    }
+    return resultado;
+}
+
+// Métricas em um objeto JSON; os campos não medidos pela busca são omitidos
+string metricasEmJson(const MetricasBusca &metricas)
+{
+    string json = "{\"expandidos\":" + to_string(metricas.expandidos);
+    json += ",\"maior_visitados\":" + to_string(metricas.maiorVisitados);
+    if (metricas.instrumentada)
+    {
+        json += ",\"gerados\":" + to_string(metricas.gerados);
+        json += ",\"duplicados\":" + to_string(metricas.duplicados);
+        json += ",\"reabertos\":" + to_string(metricas.reabertos);
+        json += ",\"maior_aberta\":" + to_string(metricas.maiorAberta);
+        json += ",\"bytes\":" + to_string(metricas.bytes);
+    }
+    if (metricas.nanosGeracao >= 0)
+    {
+        json += ",\"ns_geracao\":" + to_string(metricas.nanosGeracao);
+        json += ",\"ns_consulta\":" + to_string(metricas.nanosConsulta);
+        json += ",\"ns_fila\":" + to_string(metricas.nanosFila);
+    }
+    return json + "}";
+}
+
+// Escapa um texto para uso dentro de uma string JSON
+string textoJson(const string &texto)
+{
+    string saida = "\"";
+    for (char c : texto)
+    {
+        if (c == '"' || c == '\\')
+            saida += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20)
+            saida += c;
+    }
+    return saida + "\"";
+}
+
+// Mensagem do detalhe "Erro" do resultado (vazia se a busca não falhou)
+string erroResultado(const ResultadoBusca &resultado)
+{
+    for (const auto &detalhe : resultado.detalhes)
+    {
+        if (detalhe.first == "Erro")
+            return detalhe.second;
+    }
+    return "";
+}
+
+// Situação do resultado no JSON e no benchmark. "interrompida": o controle
+// parou a busca (prazo, limite de nós ou cancelamento) sem solução; "parcial":
+// parou mas tem a melhor solução achada até ali; "erro": a busca falhou por
+// outro motivo e registrou o detalhe "Erro".
+string statusResultado(const ResultadoBusca &resultado)
+{
+    if (!resultado.encontrou && !erroResultado(resultado).empty())
+        return "erro";
+    return resultado.encontrou ? (resultado.interrompida ? "parcial" : "ok")
+                               : (resultado.interrompida ? "interrompida" : "sem_solucao");
+}
+
+// Converte o resultado em um objeto JSON de uma linha (sem as chaves externas)
+string camposJson(const ResultadoBusca &resultado, bool incluirCaminho = true)
+{
+    string status = statusResultado(resultado);
+    string json = "\"metodo\":" + textoJson(resultado.metodo) + ",\"status\":\"" + status + "\"";
+    if (status == "erro")
+        json += ",\"erro\":" + textoJson(erroResultado(resultado));
+    if (resultado.encontrou)
+    {
+        json += ",\"profundidade\":" + to_string(resultado.caminho.size() - 1);
+        json += ",\"custo\":" + to_string(resultado.custo);
+        if (resultado.limiteSubotimalidade > 0)
+            json += ",\"limite_subotimalidade\":" + to_string(resultado.limiteSubotimalidade);
+    }
+    json += ",\"expandidos\":" + to_string(resultado.nosExpandidos);
+    json += ",\"visitados\":" + to_string(resultado.nosVisitados);
+    json += ",\"tempo_us\":" + to_string(resultado.tempoMicros);
+    json += ",\"metricas\":" + metricasEmJson(resultado.metricas);
+    if (resultado.encontrou && incluirCaminho)
+    {
+        json += ",\"caminho\":[";
+        for (size_t k = 0; k < resultado.caminho.size(); ++k)
+        {
+            json += k ? ",[" : "[";
+            for (size_t i = 0; i < resultado.caminho[k].size(); ++i)
+                json += (i ? "," : "") + to_string(resultado.caminho[k][i]);
+            json += "]";
+        }
+        json += "]";
+    }
+    return json;
+}
+
+// Função para exibir estatísticas de busca; as contagens e as métricas são
+// exibidas mesmo quando a busca não encontra solução
+void exibirEstatisticas(const ResultadoBusca &resultado)
+{
+    int nosVisitados = resultado.nosVisitados;
+    double fatorRamificacao = (nosVisitados > 1) ? static_cast<double>(resultado.nosExpandidos) / (nosVisitados - 1) : 0;
+    const MetricasBusca &metricas = resultado.metricas;
+
+    cout << "-----------------------------" << endl;
+    cout << "Metodo de Busca: " << resultado.metodo << endl;
+    if (resultado.encontrou)
+    {
+        cout << "Caminho da Solucao:" << endl;
+        for (const auto &estado : resultado.caminho)
+        {
+            for (int cap : estado)
+                cout << cap << " ";
+            cout << endl;
+        }
+        cout << "Profundidade da Solucao: " << resultado.caminho.size() - 1 << endl;
+        cout << "Custo da Solucao: " << resultado.custo << endl; // Custo unitário por passo
+        if (resultado.limiteSubotimalidade > 0)
+            cout << "Limite de Subotimalidade: " << resultado.limiteSubotimalidade << endl;
+        if (resultado.interrompida)
+            cout << "Busca interrompida; esta e a melhor solucao encontrada ate ali." << endl;
+    }
+    else if (resultado.interrompida)
+    {
+        cout << "Busca interrompida (prazo, orcamento de nos ou cancelamento)." << endl;
+    }
+    else
+    {
+        cout << "Nenhuma solucao encontrada." << endl;
+    }
+    cout << "Numero Total de Nos Visitados: " << nosVisitados << endl;
+    cout << "Numero Total de Nos Expandidos: " << resultado.nosExpandidos << endl;
+    cout << "Valor Medio do Fator de Ramificacao: " << fatorRamificacao << endl;
+    cout << "Tempo de Execucao: " << resultado.tempoMicros / 1000.0 << " ms" << endl;
+    cout << "Nos Expandidos por Segundo: " << static_cast<long long>(resultado.nosExpandidos / (max(resultado.tempoMicros, 1LL) / 1e6)) << endl;
+    if (resultado.threads > 1)
+        cout << "Threads: " << resultado.threads << endl;
+    if (metricas.instrumentada)
+    {
+        cout << "Nos Gerados: " << metricas.gerados << endl;
+        cout << "Duplicados Rejeitados: " << metricas.duplicados << endl;
+        cout << "Nos Reabertos: " << metricas.reabertos << endl;
+        cout << "Maior Lista Aberta: " << metricas.maiorAberta << endl;
+        cout << "Memoria Estimada: " << metricas.bytes / 1024 << " KB" << endl;
+    }
+    if (metricas.nanosGeracao >= 0)
+    {
+        cout << "Tempo por Fase (geracao/consulta/fila): " << metricas.nanosGeracao / 1e6 << " / "
+             << metricas.nanosConsulta / 1e6 << " / " << metricas.nanosFila / 1e6 << " ms" << endl;
+    }
+    for (const auto &[nome, valor] : resultado.detalhes)
+        cout << nome << ": " << valor << endl;
+    cout << "Relatorio JSON: {" << camposJson(resultado, false) << "}" << endl;
+    cout << "-----------------------------" << endl;
+}
+
+// Gerador de sucessores compartilhado pelas buscas: descarta antes de gerar os
+// movimentos que não mudam o estado (encher um jarro cheio, esvaziar um vazio,
+// transferir de um vazio ou para um cheio) e, com a simetria ativa, leva cada
+// estado à forma canônica para o conjunto de visitados. Jarros com a mesma
+// capacidade e o mesmo objetivo são intercambiáveis: a forma canônica ordena
+// os níveis dentro de cada classe, então estados que só diferem por uma
+// permutação desses jarros são visitados uma única vez. Os nós continuam
+// guardando os níveis reais, por isso os caminhos não precisam ser desfeitos.
+class GeradorSucessores
+{
+public:
+    explicit GeradorSucessores(const Instancia &inst, bool usarSimetria = configuracao.simetria)
+        : inst(inst), movimentosInst(listarMovimentos(inst.n)), sucessor(inst.n), canonico(inst.n), classeJarro(inst.n)
+    {
+        map<pair<int, int>, int> classes;
+        for (int i = 0; i < inst.n; ++i)
+        {
+            auto it = classes.emplace(make_pair(inst.capacidadeMax[i], inst.objetivo[i]), static_cast<int>(classes.size())).first;
+            classeJarro[i] = it->second;
+        }
+        vector<vector<int>> membros(classes.size());
+        for (int i = 0; i < inst.n; ++i)
+            membros[classeJarro[i]].push_back(i);
+        for (auto &grupo : membros)
+        {
+            if (grupo.size() > 1)
+                grupos.push_back(grupo);
+        }
+        simetria = usarSimetria && !grupos.empty();
+
+        // Ordem em que a Busca em Profundidade empilha os filhos, para que
+        // sejam retirados encher, esvaziar e transferir para cada j crescente
+        for (int i = inst.n - 1; i >= 0; --i)
+        {
+            for (int j = inst.n - 1; j >= 0; --j)
+            {
+                if (i != j)
+                    movimentosPilha.push_back({TRANSFERIR, i, j});
+            }
+            movimentosPilha.push_back({ESVAZIAR, i, i});
+            movimentosPilha.push_back({ENCHER, i, i});
+        }
+    }
+
+    const vector<Movimento> &movimentos() const { return movimentosInst; }
+    const vector<Movimento> &movimentosEmpilhamento() const { return movimentosPilha; }
+
+    // Classe de cada jarro: jarros da mesma classe são intercambiáveis
+    const vector<int> &classes() const { return classeJarro; }
+
+    bool simetriaAtiva() const { return simetria; }
+
+    // Usado quando a heurística da busca não é invariante às permutações
+    void desativarSimetria(const string &motivo)
+    {
+        if (simetria)
+            motivoSemSimetria = motivo;
+        simetria = false;
+    }
+
+    // Indica se o movimento não muda o estado (e conta o descarte)
+    bool movimentoNulo(const int *niveis, const Movimento &mov)
+    {
+        bool nulo = false;
+        switch (mov.tipo)
+        {
+        case TRANSFERIR:
+            nulo = niveis[mov.de] == 0 || niveis[mov.para] == inst.capacidadeMax[mov.para];
+            break;
+        case ENCHER:
+            nulo = niveis[mov.de] == inst.capacidadeMax[mov.de];
+            break;
+        case ESVAZIAR:
+            nulo = niveis[mov.de] == 0;
+            break;
+        }
+        if (nulo)
+            movimentosNulos++;
+        return nulo;
+    }
+
+    // Calcula os níveis que 'de' e 'para' teriam após o movimento, sem copiar
+    // o estado (os demais jarros não mudam); retorna false se ele é nulo, sem
+    // contá-lo: quem chama decide com contarNulo
+    bool efeito(const int *niveis, const Movimento &mov, int &novoDe, int &novoPara) const
+    {
+        novoDe = niveis[mov.de];
+        novoPara = niveis[mov.para];
+        switch (mov.tipo)
+        {
+        case TRANSFERIR:
+        {
+            int quantidade = min(novoDe, inst.capacidadeMax[mov.para] - novoPara);
+            novoDe -= quantidade;
+            novoPara += quantidade;
+            return quantidade > 0;
+        }
+        case ENCHER: // 'de' e 'para' são o mesmo jarro
+            novoDe = novoPara = inst.capacidadeMax[mov.de];
+            break;
+        case ESVAZIAR:
+            novoDe = novoPara = 0;
+            break;
+        }
+        return novoDe != niveis[mov.de];
+    }
+
+    void contarNulo() { movimentosNulos++; }
+
+    // Chama visitar(niveisSucessor) para cada movimento que muda o estado, na
+    // ordem de listarMovimentos ou, com 'ordemPilha', na ordem de empilhamento
+    // da Busca em Profundidade. Os níveis passados ficam em um buffer interno
+    // reescrito a cada sucessor.
+    template <typename Visitar>
+    void gerar(const int *niveis, Visitar &&visitar, bool ordemPilha = false)
+    {
+        for (const Movimento &mov : ordemPilha ? movimentosPilha : movimentosInst)
+        {
+            if (movimentoNulo(niveis, mov))
+                continue;
+            copy(niveis, niveis + inst.n, sucessor.begin());
+            aplicarMovimento(inst, sucessor.data(), mov);
+            visitar(static_cast<const int *>(sucessor.data()));
+        }
+    }
+
+    // Níveis usados como chave no conjunto de visitados: a forma canônica com
+    // a simetria ativa, os próprios níveis sem ela. O ponteiro retornado vale
+    // até a próxima chamada.
+    const int *chave(const int *niveis)
+    {
+        if (!simetria)
+            return niveis;
+        copy(niveis, niveis + inst.n, canonico.begin());
+        bool mudou = false;
+        for (const auto &grupo : grupos)
+        {
+            valoresGrupo.clear();
+            for (int jarro : grupo)
+                valoresGrupo.push_back(canonico[jarro]);
+            if (is_sorted(valoresGrupo.begin(), valoresGrupo.end()))
+                continue;
+            sort(valoresGrupo.begin(), valoresGrupo.end());
+            for (size_t k = 0; k < grupo.size(); ++k)
+                canonico[grupo[k]] = valoresGrupo[k];
+            mudou = true;
+        }
+        if (mudou)
+            estadosPermutados++;
+        return canonico.data();
+    }
+
+    void registrarEstatisticas(ResultadoBusca &resultado) const
+    {
+        resultado.detalhes.push_back({"Sucessores nulos descartados", to_string(movimentosNulos)});
+        if (simetria)
+        {
+            resultado.detalhes.push_back({"Classes de jarros intercambiaveis", to_string(grupos.size())});
+            resultado.detalhes.push_back({"Estados levados a forma canonica", to_string(estadosPermutados)});
+        }
+        else if (!motivoSemSimetria.empty())
+        {
+            resultado.detalhes.push_back({"Simetria", "desativada (" + motivoSemSimetria + ")"});
+        }
+    }
+
+private:
+    const Instancia &inst;
+    vector<Movimento> movimentosInst, movimentosPilha;
+    vector<int> sucessor, canonico, valoresGrupo;
+    vector<int> classeJarro;
+    vector<vector<int>> grupos; // classes com mais de um jarro
+    bool simetria = false;
+    string motivoSemSimetria;
+    long long movimentosNulos = 0, estadosPermutados = 0;
+};
+
+// Resolvedor especializado para um número de jarros N conhecido em tempo de
+// compilação. Os níveis ficam em um std::array<uint16_t, N>; com N <= 8 o
+// estado inteiro ocupa no máximo 128 bits e é copiado diretamente para a
+// chave, sem codificação bit a bit. O teste de objetivo compara duas palavras
+// de 64 bits com a chave do objetivo, e a soma das diferenças é atualizada só
+// nos jarros tocados pelo movimento. Os laços sobre os jarros têm tamanho
+// constante e o compilador os desenrola. A ordem dos sucessores e a forma de
+// contar nós são as mesmas das buscas genéricas.
+template <int N>
+class ResolvedorFixo
+{
+public:
+    static_assert(N >= 1 && N <= 8, "o estado precisa caber em 128 bits");
+    using Niveis = array<uint16_t, N>;
+
+    // Indica se a instância pode usar a especialização
+    static bool suporta(const Instancia &inst, const vector<Capacidade> &jarros)
+    {
+        if (inst.n != N)
+            return false;
+        for (int i = 0; i < N; ++i)
+        {
+            if (inst.capacidadeMax[i] < 0 || inst.capacidadeMax[i] > numeric_limits<uint16_t>::max() ||
+                inst.objetivo[i] < 0 || inst.objetivo[i] > inst.capacidadeMax[i] ||
+                jarros[i].capacidadeAtual < 0 || jarros[i].capacidadeAtual > inst.capacidadeMax[i])
+                return false;
+        }
+        return true;
+    }
+
+    ResolvedorFixo(const Instancia &inst, const vector<Capacidade> &jarros)
+        : inst(inst), espaco(espacoDaThread()), estados(espaco.estados), nos(espaco.nos), visitado(espaco.visitado)
+    {
+        GeradorSucessores gerador(inst, false);
+        movimentos = gerador.movimentos();
+        movimentosPilha = gerador.movimentosEmpilhamento();
+        for (int i = 0; i < N; ++i)
+        {
+            capacidades[i] = static_cast<uint16_t>(inst.capacidadeMax[i]);
+            objetivo[i] = static_cast<uint16_t>(inst.objetivo[i]);
+            inicial[i] = static_cast<uint16_t>(jarros[i].capacidadeAtual);
+        }
+        chaveObjetivo = chave(objetivo);
+    }
+
+    static ChaveEstado chave(const Niveis &niveis)
+    {
+        uint64_t palavras[2] = {0, 0};
+        memcpy(palavras, niveis.data(), sizeof(Niveis));
+        ChaveEstado resultado;
+        resultado.baixo = palavras[0];
+        resultado.alto = palavras[1];
+        return resultado;
+    }
+
+    // Busca em Largura: mesma estratégia de buscaEmLargura
+    ResultadoBusca largura()
+    {
+        auto start = high_resolution_clock::now();
+        MonitorBusca monitor("Busca em Largura");
+        limpar();
+        criar(inicial, -1, 0, 0);
+        visitado.inserir(chave(inicial), 0);
+
+        const ControleBusca *controle = controleAtual;
+        int nosExpandidos = 0;
+        for (int frente = 0; frente < static_cast<int>(nos.size()); ++frente)
+        {
+            if (deveInterromper(controle, nosExpandidos, nosExpandidos))
+                return montar("Busca em Largura", -1, nosExpandidos, start, true, monitor);
+            nosExpandidos++;
+            monitor.expandido(nos.size() - frente, visitado.size());
+            MedidorFase medidor(monitor, FASE_EXPANSAO);
+
+            Niveis atual = estados[frente];
+            if (chave(atual) == chaveObjetivo)
+                return montar("Busca em Largura", frente, nosExpandidos, start, false, monitor);
+
+            int custo = nos[frente].g + 1;
+            for (const Movimento &mov : movimentos)
+            {
+                Niveis novo = atual;
+                if (!aplicar(novo, mov))
+                    continue;
+                monitor.gerado();
+                bool inserido;
+                {
+                    MedidorFase consulta(monitor, FASE_CONSULTA);
+                    inserido = visitado.inserir(chave(novo), 0).second;
+                }
+                if (!inserido)
+                {
+                    monitor.duplicado();
+                    continue;
+                }
+                MedidorFase fila(monitor, FASE_FILA);
+                criar(novo, frente, custo, 0);
+            }
+        }
+        return montar("Busca em Largura", -1, nosExpandidos, start, false, monitor);
+    }
+
+    // Busca em Profundidade: mesma estratégia de buscaEmProfundidade
+    ResultadoBusca profundidade()
+    {
+        auto start = high_resolution_clock::now();
+        MonitorBusca monitor("Busca em Profundidade");
+        limpar();
+        vector<int> &pilha = espaco.pilha;
+        pilha.push_back(criar(inicial, -1, 0, 0));
+
+        const ControleBusca *controle = controleAtual;
+        int nosExpandidos = 0;
+        long long iteracoes = 0;
+        while (!pilha.empty())
+        {
+            if (deveInterromper(controle, ++iteracoes, nosExpandidos))
+                return montar("Busca em Profundidade", -1, nosExpandidos, start, true, monitor);
+
+            size_t tamanhoPilha = pilha.size();
+            int atual = pilha.back();
+            pilha.pop_back();
+            Niveis niveis = estados[atual];
+            if (!visitado.inserir(chave(niveis), 0).second)
+            {
+                monitor.duplicado();
+                continue;
+            }
+            nosExpandidos++;
+            monitor.expandido(tamanhoPilha, visitado.size());
+            MedidorFase medidor(monitor, FASE_EXPANSAO);
+
+            if (chave(niveis) == chaveObjetivo)
+                return montar("Busca em Profundidade", atual, nosExpandidos, start, false, monitor);
+
+            int custo = nos[atual].g + 1;
+            for (const Movimento &mov : movimentosPilha)
+            {
+                Niveis novo = niveis;
+                if (!aplicar(novo, mov))
+                    continue;
+                monitor.gerado();
+                bool visto;
+                {
+                    MedidorFase consulta(monitor, FASE_CONSULTA);
+                    visto = visitado.buscar(chave(novo)) != nullptr;
+                }
+                if (visto)
+                {
+                    monitor.duplicado();
+                    continue;
+                }
+                MedidorFase fila(monitor, FASE_FILA);
+                pilha.push_back(criar(novo, atual, custo, 0));
+            }
+        }
+        return montar("Busca em Profundidade", -1, nosExpandidos, start, false, monitor);
+    }
+
+    // Busca de melhor escolha: mesma estratégia de buscaMelhorEscolha. Com a
+    // soma das diferenças o h do filho vem do h do pai; com o banco de padrões
+    // os níveis são convertidos para a avaliação.
+    ResultadoBusca melhorEscolha(const string &metodo, int pesoG, int pesoH)
+    {
+        auto start = high_resolution_clock::now();
+        Heuristica avaliar(inst, pesoH != 0, pesoG != 0);
+        bool incremental = avaliar.usaSoma();
+        MonitorBusca monitor(metodo);
+        limpar();
+        ListaAberta &fila = espaco.fila;
+
+        int buffer[N];
+        auto avaliarNiveis = [&](const Niveis &niveis)
+        {
+            for (int i = 0; i < N; ++i)
+                buffer[i] = niveis[i];
+            return avaliar(buffer);
+        };
+
+        int nosExpandidos = 0;
+        int hInicial = avaliarNiveis(inicial);
+        if (hInicial >= HEURISTICA_INFINITA)
+            return montar(metodo, -1, nosExpandidos, start, false, monitor);
+        fila.inserir(pesoH * hInicial, criar(inicial, -1, 0, hInicial));
+
+        const ControleBusca *controle = controleAtual;
+        long long iteracoes = 0;
+        while (!fila.vazia())
+        {
+            if (deveInterromper(controle, ++iteracoes, nosExpandidos))
+                return montar(metodo, -1, nosExpandidos, start, true, monitor);
+
+            size_t tamanhoFila = fila.size();
+            int atual = fila.retirar();
+            Niveis niveis = estados[atual];
+            if (!visitado.inserir(chave(niveis), 0).second)
+            {
+                monitor.duplicado();
+                continue;
+            }
+            nosExpandidos++;
+            monitor.expandido(tamanhoFila, visitado.size());
+            MedidorFase medidor(monitor, FASE_EXPANSAO);
+
+            if (chave(niveis) == chaveObjetivo)
+                return montar(metodo, atual, nosExpandidos, start, false, monitor);
+
+            int custo = nos[atual].g + 1;
+            int hPai = nos[atual].h;
+            for (const Movimento &mov : movimentos)
+            {
+                Niveis novo = niveis;
+                if (!aplicar(novo, mov))
+                    continue;
+                monitor.gerado();
+                bool visto;
+                {
+                    MedidorFase consulta(monitor, FASE_CONSULTA);
+                    visto = visitado.buscar(chave(novo)) != nullptr;
+                }
+                if (visto)
+                {
+                    monitor.duplicado();
+                    continue;
+                }
+                int h = incremental ? hPai + variacaoSoma(niveis, novo, mov) : avaliarNiveis(novo);
+                if (h >= HEURISTICA_INFINITA)
+                    continue;
+                MedidorFase medidorFila(monitor, FASE_FILA);
+                fila.inserir(pesoG * custo + pesoH * h, criar(novo, atual, custo, h));
+            }
+        }
+        return montar(metodo, -1, nosExpandidos, start, false, monitor);
+    }
+
+private:
+    // Memória de trabalho de cada thread, reaproveitada entre as execuções:
+    // em um processo que resolve muitas instâncias seguidas (modo serviço,
+    // lote) a tabela de visitados, os vetores de nós e a lista aberta já vêm
+    // alocados e só são esvaziados. O que passar de LIMITE_QUENTE posições é
+    // devolvido ao fim de cada busca, para uma instância grande não deixar a
+    // thread presa a muita memória.
+    struct EspacoTrabalho
+    {
+        vector<Niveis> estados;
+        vector<No> nos;
+        vector<int> pilha;
+        TabelaChaves<uint8_t> visitado;
+        ListaAberta fila{LISTA_HEAP};
+    };
+    static constexpr size_t LIMITE_QUENTE = static_cast<size_t>(1) << 18;
+
+    static EspacoTrabalho &espacoDaThread()
+    {
+        thread_local EspacoTrabalho espaco;
+        return espaco;
+    }
+
+    const Instancia &inst;
+    EspacoTrabalho &espaco;
+    vector<Movimento> movimentos, movimentosPilha;
+    Niveis capacidades{}, objetivo{}, inicial{};
+    ChaveEstado chaveObjetivo;
+    vector<Niveis> &estados; // níveis de cada nó, indexados como 'nos'
+    vector<No> &nos;
+    TabelaChaves<uint8_t> &visitado;
+    long long movimentosNulos = 0;
+
+    template <typename Item>
+    static void esvaziar(vector<Item> &itens)
+    {
+        if (itens.capacity() > LIMITE_QUENTE)
+            vector<Item>().swap(itens);
+        else
+            itens.clear();
+    }
+
+    void limpar()
+    {
+        // Cada entrada da lista aberta é um nó criado, então ela só passou
+        // do limite se os vetores de nós também passaram
+        if (nos.capacity() > LIMITE_QUENTE)
+            espaco.fila = ListaAberta(configuracao.listaAberta);
+        else
+            espaco.fila.limpar(configuracao.listaAberta);
+        esvaziar(estados);
+        esvaziar(nos);
+        esvaziar(espaco.pilha);
+        visitado.reiniciar(LIMITE_QUENTE);
+        movimentosNulos = 0;
+    }
+
+    int criar(const Niveis &niveis, int pai, int g, int h)
+    {
+        estados.push_back(niveis);
+        nos.push_back({pai, g, h});
+        return static_cast<int>(nos.size()) - 1;
+    }
+
+    // Aplica o movimento; retorna false (e conta o descarte) se ele não muda o estado
+    bool aplicar(Niveis &niveis, const Movimento &mov)
+    {
+        switch (mov.tipo)
+        {
+        case TRANSFERIR:
+        {
+            uint16_t quantidade = min(niveis[mov.de], static_cast<uint16_t>(capacidades[mov.para] - niveis[mov.para]));
+            if (quantidade == 0)
+                break;
+            niveis[mov.de] -= quantidade;
+            niveis[mov.para] += quantidade;
+            return true;
+        }
+        case ENCHER:
+            if (niveis[mov.de] == capacidades[mov.de])
+                break;
+            niveis[mov.de] = capacidades[mov.de];
+            return true;
+        case ESVAZIAR:
+            if (niveis[mov.de] == 0)
+                break;
+            niveis[mov.de] = 0;
+            return true;
+        }
+        movimentosNulos++;
+        return false;
+    }
+
+    // Variação da soma das diferenças causada pelo movimento (só 'de' e 'para' mudam)
+    int variacaoSoma(const Niveis &antes, const Niveis &depois, const Movimento &mov) const
+    {
+        auto diferenca = [&](const Niveis &niveis, int i)
+        { return abs(static_cast<int>(niveis[i]) - static_cast<int>(objetivo[i])); };
+        int variacao = diferenca(depois, mov.de) - diferenca(antes, mov.de);
+        if (mov.para != mov.de)
+            variacao += diferenca(depois, mov.para) - diferenca(antes, mov.para);
+        return variacao;
+    }
+
+    ResultadoBusca montar(const string &metodo, int noObjetivo, int nosExpandidos,
+                          high_resolution_clock::time_point inicio, bool interrompida, MonitorBusca &monitor)
+    {
+        ResultadoBusca resultado;
+        resultado.metodo = metodo;
+        resultado.interrompida = interrompida;
+        resultado.nosVisitados = static_cast<int>(visitado.size());
+        resultado.nosExpandidos = nosExpandidos;
+        if (noObjetivo != -1)
+        {
+            resultado.encontrou = true;
+            resultado.custo = nos[noObjetivo].g;
+            for (int atual = noObjetivo; atual != -1; atual = nos[atual].pai)
+                resultado.caminho.emplace_back(estados[atual].begin(), estados[atual].end());
+            reverse(resultado.caminho.begin(), resultado.caminho.end());
+        }
+        resultado.tempoMicros = duration_cast<microseconds>(high_resolution_clock::now() - inicio).count();
+        resultado.metricas = monitor.finalizar(visitado.bytes() + estados.capacity() * sizeof(Niveis) + nos.capacity() * sizeof(No));
+        resultado.detalhes.push_back({"Sucessores nulos descartados", to_string(movimentosNulos)});
+        resultado.detalhes.push_back({"Resolvedor", "especializado para " + to_string(N) + " jarros"});
+        return resultado;
+    }
+};
+
+enum TipoBuscaFixa
+{
+    FIXA_LARGURA,
+    FIXA_PROFUNDIDADE,
+    FIXA_MELHOR_ESCOLHA
+};
+
+template <int N>
+ResultadoBusca executarResolvedorFixo(const Instancia &inst, const vector<Capacidade> &jarros, TipoBuscaFixa tipo,
+                                      const string &metodo, int pesoG, int pesoH)
+{
+    ResolvedorFixo<N> resolvedor(inst, jarros);
+    switch (tipo)
+    {
+    case FIXA_LARGURA:
+        return resolvedor.largura();
+    case FIXA_PROFUNDIDADE:
+        return resolvedor.profundidade();
+    default:
+        return resolvedor.melhorEscolha(metodo, pesoG, pesoH);
+    }
+}
+
+// Escolhe em tempo de execução o resolvedor especializado para o número de
+// jarros (2 a 8). Retorna false quando não há especialização aplicável e a
+// busca deve seguir pelo caminho genérico: outro número de jarros,
+// capacidades acima de 16 bits ou jarros intercambiáveis com a simetria ativa
+// (a forma canônica só existe no caminho genérico).
+bool resolverEspecializado(const vector<Capacidade> &jarros, TipoBuscaFixa tipo, const string &metodo, int pesoG, int pesoH,
+                           ResultadoBusca &resultado)
+{
+    if (!configuracao.resolvedoresEspecializados)
+        return false;
+    Instancia inst = criarInstancia(jarros);
+    if (inst.n < 2 || inst.n > 8 || GeradorSucessores(inst).simetriaAtiva())
+        return false;
+
+    switch (inst.n)
+    {
+#define RESOLVER_FIXO(n)                                                                  \
+    case n:                                                                               \
+        if (!ResolvedorFixo<n>::suporta(inst, jarros))                                    \
+            return false;                                                                 \
+        resultado = executarResolvedorFixo<n>(inst, jarros, tipo, metodo, pesoG, pesoH); \
+        return true;
+        RESOLVER_FIXO(2)
+        RESOLVER_FIXO(3)
+        RESOLVER_FIXO(4)
+        RESOLVER_FIXO(5)
+        RESOLVER_FIXO(6)
+        RESOLVER_FIXO(7)
+        RESOLVER_FIXO(8)
+#undef RESOLVER_FIXO
+    }
+    return false;
+}
+
+// Função de Backtracking sem recursão: uma pilha explícita guarda, para cada
+// nível, o próximo movimento a tentar e os níveis sobrescritos pelo movimento
+// que levou até ele. Os movimentos são aplicados e desfeitos em um único
+// vetor de níveis, na mesma ordem da versão recursiva (transferir de i para
+// cada j, encher i, esvaziar i), e os estados visitados continuam marcados
+// para sempre. 'profundidadeMaxima' limita a descida (0 = sem limite); com
+// limite, cada estado guarda a menor profundidade em que foi alcançado e volta
+// a ser expandido se um caminho mais curto chegar a ele, senão um primeiro
+// caminho longo esconderia soluções que cabem no limite.
+ResultadoBusca buscaBacktracking(const vector<Capacidade> &jarros, int profundidadeMaxima)
+{
+    Instancia inst = criarInstancia(jarros);
+    GeradorSucessores gerador(inst);
+    const vector<Movimento> &movimentos = gerador.movimentos();
+    int totalMovimentos = static_cast<int>(movimentos.size());
+    bool limitada = profundidadeMaxima > 0;
+    ConjuntoVisitados visitado(inst, limitada);
+    vector<int> profundidades; // por número de ordem do estado, só com limite
+    long long reabertos = 0;
+
+    struct Quadro
+    {
+        int proximo = 0;    // próximo movimento a tentar
+        int movimento = -1; // movimento que levou a este nível
+        int de = 0, para = 0, antigoDe = 0, antigoPara = 0;
+    };
+
+    vector<int> niveis = converterEstado(jarros);
+    vector<Quadro> pilha;
+    long long nosExpandidos = 0;
+    size_t maiorProfundidade = 0;
+    bool encontrou = false;
+
+    auto start = high_resolution_clock::now();
+    MonitorBusca monitor("Busca em Backtracking");
+
+    if (atingiuObjetivos(inst, niveis.data()))
+    {
+        encontrou = true;
+        pilha.push_back(Quadro());
+    }
+    else
+    {
+        visitado.inserir(gerador.chave(niveis.data()));
+        profundidades.assign(limitada ? 1 : 0, 0);
+        nosExpandidos++;
+        pilha.push_back(Quadro());
+        monitor.expandido(pilha.size(), visitado.size());
+    }
+
+    const ControleBusca *controle = controleAtual;
+    bool interrompida = false;
+    long long iteracoes = 0;
+
+    while (!encontrou && !pilha.empty())
+    {
+        if (deveInterromper(controle, ++iteracoes, nosExpandidos))
+        {
+            interrompida = true;
+            break;
+        }
+        MedidorFase medidor(monitor, FASE_EXPANSAO);
+
+        Quadro &topo = pilha.back();
+        int profundidade = static_cast<int>(pilha.size()) - 1; // do estado no topo
+        bool noLimite = limitada && profundidade >= profundidadeMaxima;
+        if (topo.proximo == totalMovimentos || noLimite)
+        {
+            // Remove o estado se não conduzir à solução
+            niveis[topo.de] = topo.antigoDe;
+            niveis[topo.para] = topo.antigoPara;
+            pilha.pop_back();
+            continue;
+        }
+
+        Quadro filho;
+        filho.movimento = topo.proximo;
+        const Movimento &mov = movimentos[topo.proximo++];
+        if (gerador.movimentoNulo(niveis.data(), mov))
+            continue; // o estado não mudaria, então já está visitado
+        filho.de = mov.de;
+        filho.para = mov.para;
+        filho.antigoDe = niveis[mov.de];
+        filho.antigoPara = niveis[mov.para];
+        aplicarMovimento(inst, niveis.data(), mov);
+        monitor.gerado();
+
+        if (atingiuObjetivos(inst, niveis.data()))
+        {
+            pilha.push_back(filho); // Inclui o estado final
+            encontrou = true;
+            break;
+        }
+
+        bool novo;
+        {
+            MedidorFase medidor(monitor, FASE_CONSULTA);
+            if (!limitada)
+            {
+                novo = visitado.inserir(gerador.chave(niveis.data()));
+            }
+            else
+            {
+                uint32_t ordem = visitado.numerar(gerador.chave(niveis.data()), novo);
+                if (novo)
+                {
+                    profundidades.push_back(profundidade + 1);
+                }
+                else if (profundidade + 1 < profundidades[ordem])
+                {
+                    profundidades[ordem] = profundidade + 1; // caminho mais curto: expande de novo
+                    reabertos++;
+                    monitor.reaberto();
+                    novo = true;
+                }
+            }
+        }
+        if (!novo)
+        {
+            monitor.duplicado();
+            niveis[filho.de] = filho.antigoDe;
+            niveis[filho.para] = filho.antigoPara;
+            continue;
+        }
+
+        nosExpandidos++; // Contador de nós expandidos
+        MedidorFase medidorFila(monitor, FASE_FILA);
+        pilha.push_back(filho);
+        monitor.expandido(pilha.size(), visitado.size());
+        maiorProfundidade = max(maiorProfundidade, pilha.size() - 1);
+    }
+
+    ResultadoBusca resultado;
+    resultado.tempoMicros = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    resultado.metodo = "Busca em Backtracking";
+    resultado.nosVisitados = static_cast<int>(visitado.size());
+    resultado.nosExpandidos = static_cast<int>(nosExpandidos);
+    resultado.encontrou = encontrou;
+    resultado.interrompida = interrompida;
+    resultado.metricas = monitor.finalizar(visitado.bytes() + pilha.capacity() * sizeof(Quadro) +
+                                           profundidades.capacity() * sizeof(int));
+    resultado.detalhes.push_back({"Maior profundidade alcancada", to_string(maiorProfundidade)});
+    if (limitada)
+    {
+        resultado.detalhes.push_back({"Limite de profundidade", to_string(profundidadeMaxima)});
+        resultado.detalhes.push_back({"Estados reabertos por caminho mais curto", to_string(reabertos)});
+    }
+    gerador.registrarEstatisticas(resultado);
+    if (!encontrou)
+        return resultado;
+
+    // A pilha guarda o caminho: reaplica os movimentos a partir do início
+    resultado.caminho.push_back(converterEstado(jarros));
+    for (size_t nivel = 1; nivel < pilha.size(); ++nivel)
+    {
+        vector<int> estado = resultado.caminho.back();
+        aplicarMovimento(inst, estado.data(), movimentos[pilha[nivel].movimento]);
+        resultado.caminho.push_back(estado);
+    }
+    resultado.custo = static_cast<int>(pilha.size()) - 1;
+    return resultado;
+}
+
+// Função de Busca em Largura (BFS)
+ResultadoBusca buscaEmLargura(const vector<Capacidade> &jarros)
+{
+    ResultadoBusca especializado;
+    if (resolverEspecializado(jarros, FIXA_LARGURA, "", 0, 0, especializado))
+        return especializado;
+
+    Instancia inst = criarInstancia(jarros);
+    GeradorSucessores gerador(inst);
+    ArenaNos arena(inst.n);
+    ConjuntoVisitados visitado(inst);
+    int nosExpandidos = 0;
+
+    vector<int> estadoAtual(inst.n);
+    vector<int> estadoInicial = converterEstado(jarros);
+
+    auto start = high_resolution_clock::now();
+    MonitorBusca monitor("Busca em Largura");
+
+    visitado.inserir(gerador.chave(estadoInicial.data()));
+    arena.criar(estadoInicial.data(), -1, 0, 0);
+
+    auto concluir = [&](int noObjetivo, bool interrompida)
+    {
+        ResultadoBusca resultado = montarResultado("Busca em Largura", arena, noObjetivo, visitado.size(), nosExpandidos, start, interrompida);
+        resultado.metricas = monitor.finalizar(visitado.bytes() + arena.bytes());
+        gerador.registrarEstatisticas(resultado);
+        return resultado;
+    };
+
+    // Os nós entram na arena na mesma ordem da fila, então a própria arena
+    // funciona como fila: 'frente' é o próximo nó a ser expandido
+    const ControleBusca *controle = controleAtual;
+    for (int frente = 0; frente < arena.size(); ++frente)
+    {
+        if (deveInterromper(controle, nosExpandidos, nosExpandidos))
+            return concluir(-1, true);
+
+        copy(arena.niveis(frente), arena.niveis(frente) + inst.n, estadoAtual.begin());
+        nosExpandidos++;
+        monitor.expandido(static_cast<size_t>(arena.size() - frente), visitado.size());
+        MedidorFase medidor(monitor, FASE_EXPANSAO);
+
+        // Verifica se atingimos o objetivo
+        if (atingiuObjetivos(inst, estadoAtual.data()))
+            return concluir(frente, false);
+
+        // Gera estados filhos; cada estado entra na fila uma única vez
+        int custo = arena.no(frente).g + 1;
+        gerador.gerar(estadoAtual.data(), [&](const int *novoEstado)
+                      {
+            monitor.gerado();
+            bool novo;
+            {
+                MedidorFase consulta(monitor, FASE_CONSULTA);
+                novo = visitado.inserir(gerador.chave(novoEstado));
+            }
+            if (!novo)
+            {
+                monitor.duplicado();
+                return;
+            }
+            MedidorFase fila(monitor, FASE_FILA);
+            arena.criar(novoEstado, frente, custo, 0); });
+    }
+
+    return concluir(-1, false);
+}
+
+// Função de Busca em Profundidade (DFS) usando Pilha
+ResultadoBusca buscaEmProfundidade(const vector<Capacidade> &jarros)
+{
+    ResultadoBusca especializado;
+    if (resolverEspecializado(jarros, FIXA_PROFUNDIDADE, "", 0, 0, especializado))
+        return especializado;
+
+    Instancia inst = criarInstancia(jarros);
+    GeradorSucessores gerador(inst);
+    ArenaNos arena(inst.n);
+    ConjuntoVisitados visitado(inst);
+    stack<int> pilha; // índices de nós na arena
+    int nosExpandidos = 0;
+
+    vector<int> estadoAtual(inst.n);
+    vector<int> estadoInicial = converterEstado(jarros);
+
+    auto start = high_resolution_clock::now();
+
+    MonitorBusca monitor("Busca em Profundidade");
+    pilha.push(arena.criar(estadoInicial.data(), -1, 0, 0));
+
+    auto concluir = [&](int noObjetivo, bool interrompida)
+    {
+        ResultadoBusca resultado = montarResultado("Busca em Profundidade", arena, noObjetivo, visitado.size(), nosExpandidos, start, interrompida);
+        resultado.metricas = monitor.finalizar(visitado.bytes() + arena.bytes() + monitor.maiorAberta() * sizeof(int));
+        gerador.registrarEstatisticas(resultado);
+        return resultado;
+    };
+
+    const ControleBusca *controle = controleAtual;
+    long long iteracoes = 0;
+    while (!pilha.empty())
+    {
+        if (deveInterromper(controle, ++iteracoes, nosExpandidos))
+            return concluir(-1, true);
+
+        size_t tamanhoPilha = pilha.size();
+        int atual = pilha.top();
+        pilha.pop();
+
+        copy(arena.niveis(atual), arena.niveis(atual) + inst.n, estadoAtual.begin());
+        if (!visitado.inserir(gerador.chave(estadoAtual.data())))
+        {
+            monitor.duplicado(); // empilhado mais de uma vez antes de ser expandido
+            continue;
+        }
+
+        nosExpandidos++;
+        monitor.expandido(tamanhoPilha, visitado.size());
+        MedidorFase medidor(monitor, FASE_EXPANSAO);
+
+        // Verifica se atingimos o objetivo
+        if (atingiuObjetivos(inst, estadoAtual.data()))
+            return concluir(atual, false);
+
+        // Gera estados filhos (na ordem de empilhamento)
+        int custo = arena.no(atual).g + 1;
+        gerador.gerar(estadoAtual.data(), [&](const int *novoEstado)
+                      {
+            monitor.gerado();
+            bool visto;
+            {
+                MedidorFase consulta(monitor, FASE_CONSULTA);
+                visto = visitado.contem(gerador.chave(novoEstado));
+            }
+            if (visto)
+            {
+                monitor.duplicado();
+                return;
+            }
+            MedidorFase fila(monitor, FASE_FILA);
+            pilha.push(arena.criar(novoEstado, atual, custo, 0)); }, true);
+    }
+
+    return concluir(-1, false);
+}
+
+// Busca de melhor escolha com expansão parcial (Enhanced Partial Expansion
+// A*). Na busca completa todos os filhos de um nó entram na lista aberta,
+// embora a maioria nunca saia antes de o objetivo ser encontrado. Aqui cada
+// nó guarda um valor F (de início o seu f): ao ser retirado, só entram na
+// lista os filhos com f igual a F e o próprio nó volta à lista com F = menor
+// f entre os filhos que ficaram de fora. Na primeira expansão entram também
+// os filhos com f menor que o do pai (heurística inconsistente ou gulosa).
+//
+// O f de cada filho vem da variação causada pelo movimento: o custo sobe
+// pesoG e, com a soma das diferenças, h muda só nos dois jarros tocados, que
+// GeradorSucessores::efeito calcula sem montar o estado. O filho só é montado
+// quando vai para a lista. Com o banco de padrões não há variação local e o
+// filho precisa ser montado para ser avaliado, mas a lista continua só com os
+// filhos do F atual. Cada filho entra com a mesma prioridade que teria na
+// busca completa antes de sair qualquer nó de prioridade maior, então os nós
+// são fechados na mesma ordem de f e o custo da solução não muda.
+ResultadoBusca buscaExpansaoParcial(const vector<Capacidade> &jarros, const string &metodo, int pesoG, int pesoH)
+{
+    Instancia inst = criarInstancia(jarros);
+    GeradorSucessores gerador(inst);
+    ArenaNos arena(inst.n);
+    ConjuntoVisitados visitado(inst);
+    ListaAberta fila(configuracao.listaAberta);
+    vector<int> valorF;         // F de cada nó da arena
+    vector<uint8_t> iniciado;   // 1 depois da primeira expansão do nó
+    int nosExpandidos = 0;
+    long long reexpansoes = 0, adiados = 0, operacoesFila = 0;
+
+    vector<int> estadoAtual(inst.n), filho(inst.n);
+    vector<int> estadoInicial = converterEstado(jarros);
+
+    auto start = high_resolution_clock::now();
+
+    Heuristica avaliar(inst, pesoH != 0, pesoG != 0);
+    if (!avaliar.simetrica(gerador.classes()))
+        gerador.desativarSimetria("heuristica nao e invariante a permutacoes");
+    bool variacaoLocal = pesoH == 0 || avaliar.usaSoma();
+
+    MonitorBusca monitor(metodo);
+    auto concluir = [&](int noObjetivo, bool interrompida)
+    {
+        ResultadoBusca resultado = montarResultado(metodo, arena, noObjetivo, visitado.size(), nosExpandidos, start, interrompida);
+        resultado.metricas = monitor.finalizar(visitado.bytes() + arena.bytes() + valorF.capacity() * (sizeof(int) + 1) +
+                                               monitor.maiorAberta() * sizeof(pair<int, int>));
+        resultado.detalhes.push_back({"Reexpansoes parciais", to_string(reexpansoes)});
+        resultado.detalhes.push_back({"Filhos adiados", to_string(adiados)});
+        resultado.detalhes.push_back({"Operacoes na lista aberta", to_string(operacoesFila)});
+        gerador.registrarEstatisticas(resultado);
+        return resultado;
+    };
+    auto inserir = [&](const int *niveis, int pai, int g, int h, int f)
+    {
+        int indice = arena.criar(niveis, pai, g, h);
+        valorF.push_back(f);
+        iniciado.push_back(0);
+        fila.inserir(f, indice);
+        operacoesFila++;
+    };
+
+    int hInicial = avaliar(estadoInicial.data());
+    if (hInicial >= HEURISTICA_INFINITA)
+        return concluir(-1, false);
+    inserir(estadoInicial.data(), -1, 0, hInicial, pesoH * hInicial);
+
+    const ControleBusca *controle = controleAtual;
+    long long iteracoes = 0;
+    while (!fila.vazia())
+    {
+        if (deveInterromper(controle, ++iteracoes, nosExpandidos))
+            return concluir(-1, true);
+
+        size_t tamanhoFila = fila.size();
+        int atual = fila.retirar();
+        operacoesFila++;
+        copy(arena.niveis(atual), arena.niveis(atual) + inst.n, estadoAtual.begin());
+
+        bool primeira = !iniciado[atual];
+        if (primeira)
+        {
+            if (!visitado.inserir(gerador.chave(estadoAtual.data())))
+            {
+                monitor.duplicado(); // inserido na fila mais de uma vez antes de ser expandido
+                continue;
+            }
+            iniciado[atual] = 1;
+            nosExpandidos++;
+            monitor.expandido(tamanhoFila, visitado.size());
+            if (atingiuObjetivos(inst, estadoAtual.data()))
+                return concluir(atual, false);
+        }
+        else
+        {
+            reexpansoes++;
+        }
+        MedidorFase medidor(monitor, FASE_EXPANSAO);
+
+        const No no = arena.no(atual);
+        int custo = no.g + 1, fPai = valorF[atual];
+        int proximoF = numeric_limits<int>::max();
+        for (const Movimento &mov : gerador.movimentos())
+        {
+            int novoDe, novoPara;
+            if (!gerador.efeito(estadoAtual.data(), mov, novoDe, novoPara))
+            {
+                if (primeira)
+                    gerador.contarNulo();
+                continue;
+            }
+
+            int h = 0;
+            if (variacaoLocal && pesoH != 0)
+            {
+                h = no.h + abs(novoDe - inst.objetivo[mov.de]) - abs(estadoAtual[mov.de] - inst.objetivo[mov.de]);
+                if (mov.para != mov.de)
+                    h += abs(novoPara - inst.objetivo[mov.para]) - abs(estadoAtual[mov.para] - inst.objetivo[mov.para]);
+            }
+            if (!variacaoLocal || (primeira ? pesoG * custo + pesoH * h <= fPai : pesoG * custo + pesoH * h == fPai))
+            {
+                copy(estadoAtual.begin(), estadoAtual.end(), filho.begin());
+                filho[mov.de] = novoDe;
+                filho[mov.para] = novoPara;
+                if (!variacaoLocal)
+                {
+                    h = avaliar(filho.data());
+                    if (h >= HEURISTICA_INFINITA)
+                        continue; // o banco de padrões prova que o estado não alcança o objetivo
+                }
+            }
+            int f = pesoG * custo + pesoH * h;
+            if (!primeira && f < fPai)
+                continue; // já entrou na lista na primeira expansão
+            if (f > fPai)
+            {
+                proximoF = min(proximoF, f);
+                if (primeira)
+                    adiados++;
+                continue;
+            }
+
+            monitor.gerado();
+            bool visto;
+            {
+                MedidorFase consulta(monitor, FASE_CONSULTA);
+                visto = visitado.contem(gerador.chave(filho.data()));
+            }
+            if (visto)
+            {
+                monitor.duplicado();
+                continue;
+            }
+            MedidorFase medidorFila(monitor, FASE_FILA);
+            inserir(filho.data(), atual, custo, h, f);
+        }
+
+        // O nó volta à lista para liberar os filhos do próximo F
+        if (proximoF != numeric_limits<int>::max())
+        {
+            valorF[atual] = proximoF;
+            fila.inserir(proximoF, atual);
+            operacoesFila++;
+        }
+    }
+
+    return concluir(-1, false);
+}
+
+// Busca de melhor escolha compartilhada por Busca Ordenada, Gulosa e A*:
+// a prioridade de cada nó é pesoG * g + pesoH * h
+ResultadoBusca buscaMelhorEscolha(const vector<Capacidade> &jarros, const string &metodo, int pesoG, int pesoH)
+{
+    if (configuracao.expansaoParcial)
+        return buscaExpansaoParcial(jarros, metodo + " (expansao parcial)", pesoG, pesoH);
+
+    ResultadoBusca especializado;
+    if (resolverEspecializado(jarros, FIXA_MELHOR_ESCOLHA, metodo, pesoG, pesoH, especializado))
+        return especializado;
+
+    Instancia inst = criarInstancia(jarros);
+    GeradorSucessores gerador(inst);
+    ArenaNos arena(inst.n);
+    ConjuntoVisitados visitado(inst);
+    int nosExpandidos = 0;
+
+    ListaAberta fila(configuracao.listaAberta);
+
+    vector<int> estadoAtual(inst.n);
+    vector<int> estadoInicial = converterEstado(jarros);
+
+    auto start = high_resolution_clock::now();
+
+    // Na primeira busca da instância inclui a construção do banco de padrões
+    Heuristica avaliar(inst, pesoH != 0, pesoG != 0); // a Gulosa mantém a soma das diferenças
+    if (!avaliar.simetrica(gerador.classes()))
+        gerador.desativarSimetria("heuristica nao e invariante a permutacoes");
+
+    MonitorBusca monitor(metodo);
+    auto concluir = [&](int noObjetivo, bool interrompida)
+    {
+        ResultadoBusca resultado = montarResultado(metodo, arena, noObjetivo, visitado.size(), nosExpandidos, start, interrompida);
+        resultado.metricas = monitor.finalizar(visitado.bytes() + arena.bytes() + monitor.maiorAberta() * sizeof(pair<int, int>));
+        gerador.registrarEstatisticas(resultado);
+        return resultado;
+    };
+
+    int hInicial = avaliar(estadoInicial.data());
+    if (hInicial >= HEURISTICA_INFINITA)
+        return concluir(-1, false);
+    fila.inserir(pesoH * hInicial, arena.criar(estadoInicial.data(), -1, 0, hInicial));
+
+    const ControleBusca *controle = controleAtual;
+    long long iteracoes = 0;
+    while (!fila.vazia())
+    {
+        if (deveInterromper(controle, ++iteracoes, nosExpandidos))
+            return concluir(-1, true);
+
+        size_t tamanhoFila = fila.size();
+        int atual = fila.retirar();
+
+        copy(arena.niveis(atual), arena.niveis(atual) + inst.n, estadoAtual.begin());
+        if (!visitado.inserir(gerador.chave(estadoAtual.data())))
+        {
+            monitor.duplicado(); // inserido na fila mais de uma vez antes de ser expandido
+            continue;
+        }
+
+        nosExpandidos++;
+        monitor.expandido(tamanhoFila, visitado.size());
+        MedidorFase medidor(monitor, FASE_EXPANSAO);
+
+        if (atingiuObjetivos(inst, estadoAtual.data()))
+            return concluir(atual, false);
+
+        // Gerar novos estados
+        int custo = arena.no(atual).g + 1;
+        gerador.gerar(estadoAtual.data(), [&](const int *novoEstado)
+                      {
+            monitor.gerado();
+            bool visto;
+            {
+                MedidorFase consulta(monitor, FASE_CONSULTA);
+                visto = visitado.contem(gerador.chave(novoEstado));
+            }
+            if (visto)
+            {
+                monitor.duplicado();
+                return;
+            }
+            int h = avaliar(novoEstado);
+            if (h >= HEURISTICA_INFINITA)
+                return; // o banco de padrões prova que o estado não alcança o objetivo
+            MedidorFase medidorFila(monitor, FASE_FILA);
+            fila.inserir(pesoG * custo + pesoH * h, arena.criar(novoEstado, atual, custo, h)); });
+    }
+
+    return concluir(-1, false);
+}
+
+// Função de Busca de Custo Uniforme
+ResultadoBusca buscaOrdenada(const vector<Capacidade> &jarros)
+{
+    return buscaMelhorEscolha(jarros, "Busca Ordenada", 1, 0); // custo acumulado
+}
+
+// Função de Busca Gulosa
+ResultadoBusca buscaGulosa(const vector<Capacidade> &jarros)
+{
+    return buscaMelhorEscolha(jarros, "Busca Gulosa", 0, 1); // apenas a heurística
+}
+
+// Função de Busca A*
+ResultadoBusca buscaAEstrela(const vector<Capacidade> &jarros)
+{
+    return buscaMelhorEscolha(jarros, "A*", 1, 1); // custo acumulado + heurística
+}
+
+// Solução publicada pela busca anytime a cada melhoria
+struct SolucaoAnytime
+{
+    int custo = 0;
+    double peso = 1;        // peso da heurística na iteração que a encontrou
+    double limite = 0;      // custo <= limite * ótimo (0 = heurística não admissível)
+    long long tempoMicros = 0;
+    int nosExpandidos = 0;
+};
+
+// Entrada da lista aberta da busca anytime; entradas com g antigo são ignoradas
+struct EntradaAnytime
+{
+    double f;
+    int g;
+    int no;
+
+    // Menor f primeiro; nos empates, o nó mais fundo
+    bool operator>(const EntradaAnytime &outra) const { return f > outra.f || (f == outra.f && g < outra.g); }
+};
+
+// Busca anytime (ARA*): A* ponderado com f = g + peso * h, que começa com um
+// peso alto para achar logo uma primeira solução e reduz o peso a cada
+// iteração. Cada iteração aproveita os valores de g da anterior: os nós
+// melhorados depois de fechados vão para a lista de inconsistentes e voltam à
+// lista aberta na iteração seguinte. Com a heurística admissível, a solução
+// atual custa no máximo 'limite' vezes o ótimo, com limite = min(peso, custo /
+// menor g + h entre abertos e inconsistentes). A busca termina quando o limite
+// chega a 1 ou quando o controle da thread (prazo, orçamento de nós ou
+// cancelamento) pede, e retorna a melhor solução encontrada até ali.
+ResultadoBusca buscaAnytime(const vector<Capacidade> &jarros, const function<void(const SolucaoAnytime &)> &publicar)
+{
+    Instancia inst = criarInstancia(jarros);
+    CodificadorEstado codificador(inst);
+    if (!codificador.cabe())
+    {
+        ResultadoBusca resultado = buscaAEstrela(jarros);
+        resultado.metodo = "A* (estado nao cabe em 128 bits)";
+        return resultado;
+    }
+
+    auto start = high_resolution_clock::now();
+    // Sem simetria: um nó pode trocar de pai, e os níveis guardados precisam
+    // continuar sendo um sucessor do novo pai
+    GeradorSucessores gerador(inst, false);
+    Heuristica avaliar(inst, true);
+    MonitorBusca monitor("Busca Anytime (ARA*)");
+    ArenaNos arena(inst.n);
+    TabelaChaves<int> indices; // estado -> nó da arena
+    vector<int> fechadoEm;     // iteração em que o nó foi fechado (-1 = nunca)
+    vector<char> inconsistente;
+    vector<int> inconsistentes;
+    priority_queue<EntradaAnytime, vector<EntradaAnytime>, greater<EntradaAnytime>> aberta;
+
+    double peso = max(1.0, configuracao.pesoInicialAnytime);
+    double reducao = max(0.01, configuracao.reducaoPesoAnytime);
+    int iteracao = 0, noObjetivo = -1, nosExpandidos = 0;
+    bool interrompida = false;
+    vector<SolucaoAnytime> solucoes;
+    vector<int> estadoAtual(inst.n);
+    vector<int> estadoInicial = converterEstado(jarros);
+    const ControleBusca *controle = controleAtual;
+    long long iteracoes = 0;
+
+    auto prioridade = [&](int no)
+    { return arena.no(no).g + peso * arena.no(no).h; };
+    auto abrir = [&](int no)
+    { aberta.push({prioridade(no), arena.no(no).g, no}); };
+    auto valida = [&](const EntradaAnytime &entrada)
+    { return entrada.g == arena.no(entrada.no).g && fechadoEm[entrada.no] != iteracao; };
+    auto criarNo = [&](const int *niveis, int pai, int g, int h)
+    {
+        int no = arena.criar(niveis, pai, g, h);
+        fechadoEm.push_back(-1);
+        inconsistente.push_back(0);
+        if (atingiuObjetivos(inst, niveis))
+            noObjetivo = no;
+        return no;
+    };
+    // Comprimento do caminho guardado até o nó (pode ser menor que o g, que só diminui ao trocar de pai)
+    auto comprimento = [&](int no)
+    {
+        int passos = 0;
+        for (; arena.no(no).pai != -1; no = arena.no(no).pai)
+            passos++;
+        return passos;
+    };
+
+    int hInicial = avaliar(estadoInicial.data());
+    if (hInicial < HEURISTICA_INFINITA)
+    {
+        int raiz = criarNo(estadoInicial.data(), -1, 0, hInicial);
+        indices.inserir(codificador.codificar(estadoInicial.data()), raiz);
+        abrir(raiz);
+    }
+
+    // Expande enquanto algum aberto puder levar a uma solução melhor que a atual
+    auto melhorarCaminho = [&]
+    {
+        while (!aberta.empty())
+        {
+            EntradaAnytime topo = aberta.top();
+            if (!valida(topo))
+            {
+                aberta.pop();
+                continue;
+            }
+            if (noObjetivo != -1 && arena.no(noObjetivo).g <= topo.f)
+                return;
+            if (deveInterromper(controle, ++iteracoes, nosExpandidos))
+            {
+                interrompida = true;
+                return;
+            }
+            aberta.pop();
+            int atual = topo.no;
+            fechadoEm[atual] = iteracao;
+            nosExpandidos++;
+            monitor.expandido(aberta.size(), indices.size());
+            MedidorFase medidor(monitor, FASE_EXPANSAO);
+
+            copy(arena.niveis(atual), arena.niveis(atual) + inst.n, estadoAtual.begin());
+            int custo = arena.no(atual).g + 1;
+            gerador.gerar(estadoAtual.data(), [&](const int *novoEstado)
+                          {
+                monitor.gerado();
+                ChaveEstado chave = codificador.codificar(novoEstado);
+                int *existente;
+                {
+                    MedidorFase consulta(monitor, FASE_CONSULTA);
+                    existente = indices.buscar(chave);
+                }
+                if (!existente)
+                {
+                    int h = avaliar(novoEstado);
+                    if (h >= HEURISTICA_INFINITA)
+                        return;
+                    MedidorFase fila(monitor, FASE_FILA);
+                    int no = criarNo(novoEstado, atual, custo, h);
+                    indices.inserir(chave, no);
+                    abrir(no);
+                    return;
+                }
+                int no = *existente;
+                if (custo >= arena.no(no).g)
+                {
+                    monitor.duplicado();
+                    return;
+                }
+                arena.reparentar(no, atual, custo);
+                if (fechadoEm[no] == iteracao)
+                {
+                    // Já fechado nesta iteração: volta só na próxima
+                    monitor.reaberto();
+                    if (!inconsistente[no])
+                    {
+                        inconsistente[no] = 1;
+                        inconsistentes.push_back(no);
+                    }
+                    return;
+                }
+                MedidorFase fila(monitor, FASE_FILA);
+                abrir(no); });
+        }
+    };
+
+    // Limite de subotimalidade da solução atual (0 se a heurística não for admissível)
+    auto calcularLimite = [&]
+    {
+        if (!avaliar.admissivel())
+            return 0.0;
+        double menor = numeric_limits<double>::max();
+        vector<EntradaAnytime> entradas;
+        for (; !aberta.empty(); aberta.pop())
+        {
+            if (!valida(aberta.top()))
+                continue;
+            entradas.push_back(aberta.top());
+            menor = min(menor, static_cast<double>(aberta.top().g + arena.no(aberta.top().no).h));
+        }
+        for (const EntradaAnytime &entrada : entradas)
+            aberta.push(entrada);
+        for (int no : inconsistentes)
+            menor = min(menor, static_cast<double>(arena.no(no).g + arena.no(no).h));
+        int custo = comprimento(noObjetivo);
+        return menor >= custo ? 1.0 : min(peso, custo / menor);
+    };
+
+    while (true)
+    {
+        melhorarCaminho();
+        if (noObjetivo == -1)
+            break; // sem solução (ou interrompida antes da primeira)
+
+        SolucaoAnytime solucao;
+        solucao.custo = comprimento(noObjetivo);
+        solucao.peso = peso;
+        solucao.limite = calcularLimite();
+        solucao.tempoMicros = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+        solucao.nosExpandidos = nosExpandidos;
+        if (solucoes.empty() || solucao.custo < solucoes.back().custo || solucao.limite < solucoes.back().limite)
+        {
+            solucoes.push_back(solucao);
+            if (publicar)
+                publicar(solucao);
+        }
+        if (interrompida || peso <= 1.0 || (avaliar.admissivel() && solucao.limite <= 1.0))
+            break;
+        if (controle && controle->deveParar())
+        {
+            interrompida = true; // não vale a pena reconstruir a lista aberta
+            break;
+        }
+
+        // Próxima iteração: peso menor, inconsistentes de volta à lista aberta e fechados liberados
+        peso = max(1.0, peso - reducao);
+        vector<EntradaAnytime> entradas;
+        for (; !aberta.empty(); aberta.pop())
+        {
+            if (valida(aberta.top()))
+                entradas.push_back(aberta.top());
+        }
+        iteracao++;
+        for (const EntradaAnytime &entrada : entradas)
+            abrir(entrada.no);
+        for (int no : inconsistentes)
+        {
+            inconsistente[no] = 0;
+            abrir(no);
+        }
+        inconsistentes.clear();
+    }
+
+    ResultadoBusca resultado = montarResultado("Busca Anytime (ARA*)", arena, noObjetivo, indices.size(), nosExpandidos, start, interrompida);
+    resultado.metricas = monitor.finalizar(indices.bytes() + arena.bytes() + monitor.maiorAberta() * sizeof(EntradaAnytime));
+    if (resultado.encontrou)
+    {
+        resultado.custo = static_cast<int>(resultado.caminho.size()) - 1;
+        resultado.limiteSubotimalidade = solucoes.back().limite;
+    }
+    gerador.registrarEstatisticas(resultado);
+    resultado.detalhes.push_back({"Iteracoes", to_string(iteracao + 1)});
+    resultado.detalhes.push_back({"Peso final", to_string(peso)});
+    for (size_t k = 0; k < solucoes.size(); ++k)
+    {
+        const SolucaoAnytime &solucao = solucoes[k];
+        resultado.detalhes.push_back({"Solucao " + to_string(k + 1),
+                                      "custo " + to_string(solucao.custo) + ", peso " + to_string(solucao.peso) + ", limite " +
+                                          (solucao.limite > 0 ? to_string(solucao.limite) : "indisponivel") + ", " +
+                                          to_string(solucao.tempoMicros) + " us, " + to_string(solucao.nosExpandidos) + " expandidos"});
+    }
+    if (!avaliar.admissivel())
+        resultado.detalhes.push_back({"Limite de subotimalidade", "indisponivel (heuristica nao admissivel)"});
+    return resultado;
+}
+
+// Entrada das tabelas da busca bidirecional: o estado vizinho na direção da
+// raiz do lado (pai no lado direto, sucessor no lado reverso) e a profundidade
+struct LigacaoBidirecional
+{
+    ChaveEstado ligacao;
+    int profundidade = 0;
+};
+
+// Função de Busca em Largura Bidirecional: expande uma camada inteira por vez,
+// sempre do lado com a fronteira menor, para frente a partir do estado inicial
+// e para trás a partir do objetivo (usando gerarPredecessores)
+ResultadoBusca buscaBidirecional(const vector<Capacidade> &jarros)
+{
+    Instancia inst = criarInstancia(jarros);
+    CodificadorEstado codificador(inst);
+    if (!codificador.cabe())
+    {
+        // Sem chave compacta a busca bidirecional não se aplica; usa a BFS comum
+        ResultadoBusca resultado = buscaEmLargura(jarros);
+        resultado.metodo = "Busca em Largura (estado nao cabe em 128 bits)";
+        return resultado;
+    }
+
+    // Objetivo fora das capacidades não cabe na chave nem é alcançável: sem
+    // solução, antes de montar a busca para trás a partir dele
+    if (!objetivoCabe(inst))
+    {
+        ResultadoBusca resultado;
+        resultado.metodo = "Busca em Largura Bidirecional";
+        resultado.metricas = MonitorBusca(resultado.metodo).finalizar(0);
+        return resultado;
+    }
+
+    vector<Movimento> movimentos = listarMovimentos(inst.n);
+    int n = inst.n;
+    int nosExpandidos = 0;
+
+    vector<int> estadoInicial = converterEstado(jarros);
+    ChaveEstado chaveInicial = codificador.codificar(estadoInicial.data());
+    ChaveEstado chaveObjetivo = codificador.codificar(inst.objetivo.data());
+
+    TabelaChaves<LigacaoBidirecional> lados[2];   // 0 = para frente, 1 = para trás
+    vector<ChaveEstado> fronteiras[2];
+    lados[0].inserir(chaveInicial, {chaveInicial, 0});
+    lados[1].inserir(chaveObjetivo, {chaveObjetivo, 0});
+    fronteiras[0].push_back(chaveInicial);
+    fronteiras[1].push_back(chaveObjetivo);
+
+    vector<int> estadoAtual(n), vizinhos;
+    vector<ChaveEstado> proxima;
+    bool encontrou = chaveInicial == chaveObjetivo;
+    ChaveEstado encontro = chaveInicial;
+
+    auto start = high_resolution_clock::now();
+    MonitorBusca monitor("Busca em Largura Bidirecional");
+
+    const ControleBusca *controle = controleAtual;
+    bool interrompida = false;
+    while (!encontrou && !interrompida && !fronteiras[0].empty() && !fronteiras[1].empty())
+    {
+        int lado = fronteiras[0].size() <= fronteiras[1].size() ? 0 : 1;
+        TabelaChaves<LigacaoBidirecional> &proprio = lados[lado];
+        const TabelaChaves<LigacaoBidirecional> &outro = lados[1 - lado];
+        proxima.clear();
+
+        for (const ChaveEstado &chave : fronteiras[lado])
+        {
+            if (deveInterromper(controle, nosExpandidos, nosExpandidos))
+            {
+                interrompida = true;
+                break;
+            }
+            nosExpandidos++;
+            monitor.expandido(fronteiras[0].size() + fronteiras[1].size() + proxima.size(), lados[0].size() + lados[1].size());
+            MedidorFase medidor(monitor, FASE_EXPANSAO);
+            codificador.decodificar(chave, estadoAtual.data());
+            int profundidade = proprio.buscar(chave)->profundidade + 1;
+
+            vizinhos.clear();
+            if (lado == 0)
+            {
+                for (const Movimento &mov : movimentos)
+                {
+                    size_t inicio = vizinhos.size();
+                    vizinhos.insert(vizinhos.end(), estadoAtual.begin(), estadoAtual.end());
+                    aplicarMovimento(inst, &vizinhos[inicio], mov);
+                }
+            }
+            else
+            {
+                gerarPredecessores(inst, estadoAtual.data(), vizinhos);
+            }
+
+            for (size_t v = 0; v < vizinhos.size(); v += n)
+            {
+                monitor.gerado();
+                ChaveEstado vizinho = codificador.codificar(&vizinhos[v]);
+                bool novo;
+                {
+                    MedidorFase consulta(monitor, FASE_CONSULTA);
+                    novo = proprio.inserir(vizinho, {chave, profundidade}).second;
+                }
+                if (!novo)
+                {
+                    monitor.duplicado();
+                    continue;
+                }
+                {
+                    MedidorFase fila(monitor, FASE_FILA);
+                    proxima.push_back(vizinho);
+                }
+
+                // Antes desta camada os dois lados eram disjuntos, então o
+                // primeiro encontro já fecha um caminho de comprimento mínimo
+                if (outro.buscar(vizinho))
+                {
+                    encontrou = true;
+                    encontro = vizinho;
+                    break;
+                }
+            }
+            if (encontrou)
+                break;
+        }
+        fronteiras[lado].swap(proxima);
+    }
+
+    ResultadoBusca resultado;
+    resultado.tempoMicros = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    resultado.metodo = "Busca em Largura Bidirecional";
+    resultado.nosVisitados = static_cast<int>(lados[0].size() + lados[1].size());
+    resultado.nosExpandidos = nosExpandidos;
+    resultado.encontrou = encontrou;
+    resultado.interrompida = interrompida;
+    resultado.metricas = monitor.finalizar(lados[0].bytes() + lados[1].bytes() + monitor.maiorAberta() * sizeof(ChaveEstado));
+    if (!encontrou)
+        return resultado;
+
+    // Metade direta: do encontro até o inicial pelos pais, depois invertida
+    vector<ChaveEstado> chaves;
+    for (ChaveEstado chave = encontro;; chave = lados[0].buscar(chave)->ligacao)
+    {
+        chaves.push_back(chave);
+        if (chave == chaveInicial)
+            break;
+    }
+    reverse(chaves.begin(), chaves.end());
+    // Metade reversa: do encontro até o objetivo pelos sucessores
+    for (ChaveEstado chave = encontro; !(chave == chaveObjetivo);)
+    {
+        chave = lados[1].buscar(chave)->ligacao;
+        chaves.push_back(chave);
+    }
+
+    for (const ChaveEstado &chave : chaves)
+    {
+        codificador.decodificar(chave, estadoAtual.data());
+        resultado.caminho.push_back(estadoAtual);
+    }
+    resultado.custo = static_cast<int>(resultado.caminho.size()) - 1;
+    return resultado;
+}
+
+// Função de Busca em Largura Paralela: cada nível da fronteira é repartido em
+// blocos entre as threads do pool; cada thread guarda os sucessores novos em
+// um buffer próprio e os buffers são concatenados (cada thread copia o seu
+// trecho) para formar a próxima fronteira, sem trava global
+ResultadoBusca buscaEmLarguraParalela(const vector<Capacidade> &jarros, int numThreads)
+{
+    Instancia inst = criarInstancia(jarros);
+    CodificadorEstado codificador(inst);
+    if (!codificador.cabe())
+    {
+        ResultadoBusca resultado = buscaEmLargura(jarros);
+        resultado.metodo = "Busca em Largura (estado nao cabe em 128 bits)";
+        return resultado;
+    }
+
+    int threads = threadsDisponiveis(numThreads);
+    if (!objetivoCabe(inst))
+    {
+        ResultadoBusca resultado;
+        resultado.metodo = "Busca em Largura Paralela";
+        resultado.threads = threads;
+        return resultado;
+    }
+    int n = inst.n;
+    vector<Movimento> movimentos = listarMovimentos(n);
+
+    vector<int> estadoInicial = converterEstado(jarros);
+    ChaveEstado chaveInicial = codificador.codificar(estadoInicial.data());
+    ChaveEstado chaveObjetivo = codificador.codificar(inst.objetivo.data());
+
+    TabelaConcorrente<ChaveEstado> visitado; // estado -> pai
+    vector<ChaveEstado> fronteira;
+    vector<vector<ChaveEstado>> buffers(threads);
+    vector<size_t> deslocamentos(threads);
+    atomic<size_t> cursor(0);
+    atomic<bool> encontrou(chaveInicial == chaveObjetivo);
+    atomic<long long> nosExpandidos(0);
+    atomic<bool> interrompida(false);
+    const ControleBusca *controle = controleAtual;
+    // Com limite de nós, cada expansão reserva antes a sua vaga no orçamento
+    const bool limitado = controle && controle->limiteNos > 0;
+    atomic<long long> reservadas(0);
+    PoolThreads pool(threads);
+
+    auto start = high_resolution_clock::now();
+
+    visitado.inserir(chaveInicial, chaveInicial);
+    fronteira.push_back(chaveInicial);
+    size_t maiorFronteira = 1;
+
+    while (!encontrou.load() && !interrompida.load() && !fronteira.empty())
+    {
+        maiorFronteira = max(maiorFronteira, fronteira.size());
+        cursor = 0;
+        pool.executar([&](int id)
+                      {
+            const size_t bloco = 256;
+            vector<int> estadoAtual(n), novoEstado(n);
+            vector<ChaveEstado> &saida = buffers[id];
+            saida.clear();
+            long long expandidosLocal = 0;
+
+            while (!encontrou.load(memory_order_relaxed) && !interrompida.load(memory_order_relaxed))
+            {
+                if (controle && controle->deveParar())
+                {
+                    interrompida = true;
+                    break;
+                }
+                size_t inicio = cursor.fetch_add(bloco);
+                if (inicio >= fronteira.size())
+                    break;
+                size_t fim = min(inicio + bloco, fronteira.size());
+                for (size_t k = inicio; k < fim; ++k)
+                {
+                    if (limitado && reservadas.fetch_add(1) >= controle->limiteNos)
+                    {
+                        interrompida = true;
+                        break;
+                    }
+                    codificador.decodificar(fronteira[k], estadoAtual.data());
+                    expandidosLocal++;
+                    for (const Movimento &mov : movimentos)
+                    {
+                        novoEstado = estadoAtual;
+                        aplicarMovimento(inst, novoEstado.data(), mov);
+                        ChaveEstado chave = codificador.codificar(novoEstado.data());
+                        if (!visitado.inserir(chave, fronteira[k]).second)
+                            continue;
+                        saida.push_back(chave);
+                        if (chave == chaveObjetivo)
+                            encontrou = true;
+                    }
+                }
+            }
+            nosExpandidos += expandidosLocal; });
+
+        if (encontrou.load() || interrompida.load())
+            break;
+
+        // Junta os buffers: cada thread copia o seu na posição já calculada
+        size_t total = 0;
+        for (int id = 0; id < threads; ++id)
+        {
+            deslocamentos[id] = total;
+            total += buffers[id].size();
+        }
+        fronteira.resize(total);
+        pool.executar([&](int id)
+                      { copy(buffers[id].begin(), buffers[id].end(), fronteira.begin() + deslocamentos[id]); });
+    }
+
+    ResultadoBusca resultado;
+    resultado.tempoMicros = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    resultado.metodo = "Busca em Largura Paralela";
+    resultado.threads = threads;
+    resultado.nosVisitados = static_cast<int>(visitado.size());
+    resultado.nosExpandidos = static_cast<int>(nosExpandidos.load());
+    resultado.metricas.expandidos = nosExpandidos.load();
+    resultado.metricas.maiorVisitados = visitado.size();
+    resultado.metricas.maiorAberta = maiorFronteira;
+    resultado.encontrou = encontrou.load();
+    resultado.interrompida = !resultado.encontrou && interrompida.load();
+    if (!resultado.encontrou)
+        return resultado;
+
+    vector<int> niveis(n);
+    ChaveEstado chave = chaveObjetivo;
+    while (true)
+    {
+        codificador.decodificar(chave, niveis.data());
+        resultado.caminho.push_back(niveis);
+        if (chave == chaveInicial)
+            break;
+        visitado.buscar(chave, chave);
+    }
+    reverse(resultado.caminho.begin(), resultado.caminho.end());
+    resultado.custo = static_cast<int>(resultado.caminho.size()) - 1;
+    return resultado;
+}
+
+// Executa a BFS paralela com 1, 2, 4, ... threads e mostra a vazão obtida
+void relatorioEscalabilidadeBFS(const vector<Capacidade> &jarros)
+{
+    int maximo = threadsDisponiveis(0);
+    double base = 0;
+    cout << "Threads | Tempo (ms) | Nos Expandidos/s | Aceleracao" << endl;
+    for (int threads = 1;; threads = min(threads * 2, maximo))
+    {
+        ResultadoBusca resultado = buscaEmLarguraParalela(jarros, threads);
+        double segundos = max(resultado.tempoMicros, 1LL) / 1e6;
+        double vazao = resultado.nosExpandidos / segundos;
+        if (threads == 1)
+            base = vazao;
+        cout << threads << " | " << resultado.tempoMicros / 1000.0 << " | " << static_cast<long long>(vazao)
+             << " | " << (base > 0 ? vazao / base : 0) << "x" << endl;
+        if (threads == maximo)
+            break;
+    }
+}
+
+// Estado pendente de expansão na DFS paralela
+struct TarefaProfundidade
+{
+    ChaveEstado chave;
+    int profundidade = 0;
+};
+
+// Registro de um estado visitado pela DFS paralela, para refazer o caminho
+struct NoProfundidade
+{
+    ChaveEstado pai;
+    int profundidade = 0;
+};
+
+// Pilha de trabalho de uma thread da DFS paralela: o dono empilha e retira
+// no fim (ordem de profundidade) e quem está sem trabalho rouba do início,
+// onde ficam as tarefas mais antigas, mais perto da raiz e com as maiores
+// subárvores. Cada pilha tem a sua trava, disputada só nos roubos.
+class PilhaRoubavel
+{
+public:
+    void empilhar(const vector<TarefaProfundidade> &tarefas)
+    {
+        lock_guard<mutex> guarda(trava);
+        itens.insert(itens.end(), tarefas.begin(), tarefas.end());
+    }
+
+    bool retirar(TarefaProfundidade &tarefa)
+    {
+        lock_guard<mutex> guarda(trava);
+        if (itens.empty())
+            return false;
+        tarefa = itens.back();
+        itens.pop_back();
+        return true;
+    }
+
+    // Leva para 'destino' a metade mais antiga das tarefas (ao menos uma)
+    size_t roubar(vector<TarefaProfundidade> &destino)
+    {
+        lock_guard<mutex> guarda(trava);
+        size_t quantidade = (itens.size() + 1) / 2;
+        destino.insert(destino.end(), itens.begin(), itens.begin() + quantidade);
+        itens.erase(itens.begin(), itens.begin() + quantidade);
+        return quantidade;
+    }
+
+private:
+    mutex trava;
+    deque<TarefaProfundidade> itens;
+};
+
+// Busca em Profundidade Paralela com roubo de trabalho: cada thread
+// aprofunda a partir da sua pilha e, quando ela esvazia, rouba as tarefas
+// mais antigas de outra thread. A tabela de visitados é compartilhada e
+// dividida em fatias com travas próprias (TabelaConcorrente), então um estado
+// é expandido por uma única thread; o primeiro a gerar o objetivo acende a
+// flag 'encontrou' e todas param. A busca acaba quando não há tarefas
+// pendentes em nenhuma pilha (o contador 'pendentes' chega a zero).
+//
+// Com profundidadeMaxima > 0 (Backtracking) estados além do limite não são
+// gerados, e um estado já visitado volta a ser expandido se for alcançado por
+// um caminho mais curto, senão um primeiro caminho longo esconderia soluções
+// dentro do limite. O caminho devolvido é o da cadeia de pais, válido mas não
+// necessariamente mínimo.
+ResultadoBusca buscaEmProfundidadeParalela(const vector<Capacidade> &jarros, int numThreads, int profundidadeMaxima = 0)
+{
+    string metodo = profundidadeMaxima > 0 ? "Backtracking Paralelo" : "Busca em Profundidade Paralela";
+    Instancia inst = criarInstancia(jarros);
+    CodificadorEstado codificador(inst);
+    if (!codificador.cabe())
+    {
+        ResultadoBusca resultado = profundidadeMaxima > 0 ? buscaBacktracking(jarros, profundidadeMaxima) : buscaEmProfundidade(jarros);
+        resultado.metodo += " (estado nao cabe em 128 bits)";
+        return resultado;
+    }
+
+    int threads = threadsDisponiveis(numThreads);
+    if (!objetivoCabe(inst))
+    {
+        ResultadoBusca resultado;
+        resultado.metodo = metodo;
+        resultado.threads = threads;
+        return resultado;
+    }
+    int n = inst.n;
+    GeradorSucessores referencia(inst, false);
+    const vector<Movimento> &movimentos = referencia.movimentosEmpilhamento();
+
+    vector<int> estadoInicial = converterEstado(jarros);
+    ChaveEstado chaveInicial = codificador.codificar(estadoInicial.data());
+    ChaveEstado chaveObjetivo = codificador.codificar(inst.objetivo.data());
+
+    TabelaConcorrente<NoProfundidade> visitado;
+    vector<PilhaRoubavel> pilhas(threads);
+    vector<long long> expandidosPorThread(threads, 0);
+    atomic<long long> pendentes(1), expandidos(0), roubos(0), roubadas(0), reabertos(0);
+    atomic<bool> encontrou(chaveInicial == chaveObjetivo), interrompida(false);
+    const ControleBusca *controle = controleAtual;
+    const long long lote = controle && controle->limiteNos > 0 ? 1 : 256;
+    auto menorProfundidade = [](const NoProfundidade &novo, const NoProfundidade &guardado)
+    { return novo.profundidade < guardado.profundidade; };
+
+    auto start = high_resolution_clock::now();
+    visitado.inserir(chaveInicial, {chaveInicial, 0});
+    pilhas[0].empilhar({{chaveInicial, 0}});
+
+    PoolThreads pool(threads);
+    pool.executar([&](int id)
+                  {
+        vector<int> estadoAtual(n), novoEstado(n);
+        vector<TarefaProfundidade> filhos, roubo;
+        long long locais = 0, desdeVerificacao = 0;
+        TarefaProfundidade tarefa;
+
+        while (!encontrou.load(memory_order_relaxed) && !interrompida.load(memory_order_relaxed))
+        {
+            if (!pilhas[id].retirar(tarefa))
+            {
+                if (pendentes.load() == 0)
+                    break;
+                // Sem trabalho próprio: tenta as outras pilhas a partir da seguinte
+                bool conseguiu = false;
+                for (int passo = 1; passo < threads && !conseguiu; ++passo)
+                {
+                    roubo.clear();
+                    if (pilhas[(id + passo) % threads].roubar(roubo) > 0)
+                    {
+                        pilhas[id].empilhar(roubo);
+                        roubos++;
+                        roubadas += static_cast<long long>(roubo.size());
+                        conseguiu = true;
+                    }
+                }
+                if (!conseguiu)
+                    this_thread::yield();
+                continue;
+            }
+
+            if (profundidadeMaxima > 0)
+            {
+                // Alcançado depois por um caminho mais curto: a outra tarefa cuida dele
+                NoProfundidade registro;
+                visitado.buscar(tarefa.chave, registro);
+                if (registro.profundidade < tarefa.profundidade)
+                {
+                    pendentes--;
+                    continue;
+                }
+            }
+
+            // Só as expansões contam no total; com limite de nós ele é
+            // atualizado a cada uma, para parar exatamente no limite
+            if (++desdeVerificacao == lote)
+            {
+                long long total = expandidos.fetch_add(desdeVerificacao) + desdeVerificacao;
+                desdeVerificacao = 0;
+                if (controle && (controle->deveParar() || (controle->limiteNos > 0 && total > controle->limiteNos)))
+                {
+                    expandidos--; // esta tarefa não chega a ser expandida
+                    interrompida = true;
+                    break;
+                }
+            }
+
+            locais++;
+            filhos.clear();
+            int profundidade = tarefa.profundidade + 1;
+            if (profundidadeMaxima == 0 || profundidade <= profundidadeMaxima)
+            {
+                codificador.decodificar(tarefa.chave, estadoAtual.data());
+                for (const Movimento &mov : movimentos)
+                {
+                    novoEstado = estadoAtual;
+                    aplicarMovimento(inst, novoEstado.data(), mov);
+                    if (novoEstado == estadoAtual)
+                        continue; // movimento nulo
+                    ChaveEstado chave = codificador.codificar(novoEstado.data());
+                    NoProfundidade registro{tarefa.chave, profundidade};
+                    bool gravou;
+                    if (profundidadeMaxima > 0)
+                    {
+                        bool novo = !visitado.buscar(chave, registro);
+                        registro = {tarefa.chave, profundidade};
+                        gravou = visitado.inserirOuMelhorar(chave, registro, menorProfundidade);
+                        if (gravou && !novo)
+                            reabertos++;
+                    }
+                    else
+                    {
+                        gravou = visitado.inserir(chave, registro).second;
+                    }
+                    if (!gravou)
+                        continue;
+                    if (chave == chaveObjetivo)
+                    {
+                        encontrou = true;
+                        break;
+                    }
+                    filhos.push_back({chave, profundidade});
+                }
+            }
+            // Os filhos entram em 'pendentes' antes de a tarefa sair, para o
+            // contador nunca passar por zero enquanto ainda há trabalho
+            pendentes += static_cast<long long>(filhos.size());
+            if (!filhos.empty())
+                pilhas[id].empilhar(filhos);
+            pendentes--;
+        }
+        expandidos += desdeVerificacao;
+        expandidosPorThread[id] = locais; });
+
+    ResultadoBusca resultado;
+    resultado.tempoMicros = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    resultado.metodo = metodo;
+    resultado.threads = threads;
+    resultado.nosVisitados = static_cast<int>(visitado.size());
+    resultado.nosExpandidos = static_cast<int>(expandidos.load());
+    resultado.metricas.expandidos = expandidos.load();
+    resultado.metricas.maiorVisitados = visitado.size();
+    resultado.metricas.reabertos = reabertos.load();
+    resultado.encontrou = encontrou.load();
+    resultado.interrompida = !resultado.encontrou && interrompida.load();
+    auto [menos, mais] = minmax_element(expandidosPorThread.begin(), expandidosPorThread.end());
+    resultado.detalhes.push_back({"Roubos de trabalho (tarefas roubadas)", to_string(roubos.load()) + " (" + to_string(roubadas.load()) + ")"});
+    resultado.detalhes.push_back({"Expansoes por thread (menor / maior)", to_string(*menos) + " / " + to_string(*mais)});
+    if (profundidadeMaxima > 0)
+    {
+        resultado.detalhes.push_back({"Limite de profundidade", to_string(profundidadeMaxima)});
+        resultado.detalhes.push_back({"Estados reabertos por caminho mais curto", to_string(reabertos.load())});
+    }
+    if (!resultado.encontrou)
+        return resultado;
+
+    vector<int> niveis(n);
+    ChaveEstado chave = chaveObjetivo;
+    while (true)
+    {
+        codificador.decodificar(chave, niveis.data());
+        resultado.caminho.push_back(niveis);
+        if (chave == chaveInicial)
+            break;
+        NoProfundidade registro;
+        visitado.buscar(chave, registro);
+        chave = registro.pai;
+    }
+    reverse(resultado.caminho.begin(), resultado.caminho.end());
+    resultado.custo = static_cast<int>(resultado.caminho.size()) - 1;
+    return resultado;
+}
+
+// Caixa de mensagens sem trava para vários produtores e um consumidor: os
+// produtores empilham lotes com compare_exchange e o dono retira todos de uma vez
+template <typename Mensagem>
+class CaixaMensagens
+{
+public:
+    ~CaixaMensagens()
+    {
+        vector<Mensagem> descartadas;
+        retirarTodas(descartadas);
+    }
+
+    void enviar(vector<Mensagem> &&mensagens)
+    {
+        Lote *lote = new Lote{move(mensagens), topo.load(memory_order_relaxed)};
+        while (!topo.compare_exchange_weak(lote->proximo, lote, memory_order_release, memory_order_relaxed))
+        {
+        }
+    }
+
+    // Move todas as mensagens pendentes para 'saida'; retorna quantas foram retiradas
+    size_t retirarTodas(vector<Mensagem> &saida)
+    {
+        Lote *lote = topo.exchange(nullptr, memory_order_acquire);
+        size_t quantidade = 0;
+        while (lote)
+        {
+            quantidade += lote->mensagens.size();
+            saida.insert(saida.end(), lote->mensagens.begin(), lote->mensagens.end());
+            Lote *proximo = lote->proximo;
+            delete lote;
+            lote = proximo;
+        }
+        return quantidade;
+    }
+
+private:
+    struct Lote
+    {
+        vector<Mensagem> mensagens;
+        Lote *proximo;
+    };
+    atomic<Lote *> topo{nullptr};
+};
+
+// Estado gerado encaminhado ao trabalhador dono da sua partição
+struct MensagemHDA
+{
+    ChaveEstado estado;
+    ChaveEstado pai;
+    int g = 0;
+    int h = 0;
+};
+
+struct InfoHDA
+{
+    ChaveEstado pai;
+    int g = 0;
+    bool fechado = false;
+};
+
+struct EntradaAberta
+{
+    int f = 0;
+    int g = 0;
+    ChaveEstado chave;
+
+    // Menor f primeiro; empates favorecem o nó mais profundo
+    bool operator<(const EntradaAberta &outra) const
+    {
+        return f > outra.f || (f == outra.f && g < outra.g);
+    }
+};
+
+// Função de Busca HDA* (A* distribuído por hash): cada trabalhador é dono dos
+// estados cujo hash cai na sua partição e mantém sua própria lista aberta e
+// tabela de fechados. Estados gerados para outra partição seguem em lotes
+// pelas caixas de mensagens. A busca termina quando nenhum trabalhador tem nó
+// com f menor que a melhor solução e não há mensagens em trânsito, o que
+// mantém a otimalidade de A* (heurística admissível) e da Busca Ordenada.
+ResultadoBusca buscaHDA(const vector<Capacidade> &jarros, int numThreads, bool usarHeuristica)
+{
+    string metodo = usarHeuristica ? "HDA* (A*)" : "HDA* (Busca Ordenada)";
+    Instancia inst = criarInstancia(jarros);
+    CodificadorEstado codificador(inst);
+    if (!codificador.cabe())
+    {
+        ResultadoBusca resultado = usarHeuristica ? buscaAEstrela(jarros) : buscaOrdenada(jarros);
+        resultado.metodo += " (estado nao cabe em 128 bits)";
+        return resultado;
+    }
+
+    int trabalhadores = threadsDisponiveis(numThreads);
+    if (!objetivoCabe(inst))
+    {
+        ResultadoBusca resultado;
+        resultado.metodo = metodo;
+        resultado.threads = trabalhadores;
+        return resultado;
+    }
+    int n = inst.n;
+    vector<Movimento> movimentos = listarMovimentos(n);
+
+    vector<int> estadoInicial = converterEstado(jarros);
+    ChaveEstado chaveInicial = codificador.codificar(estadoInicial.data());
+    ChaveEstado chaveObjetivo = codificador.codificar(inst.objetivo.data());
+    Heuristica avaliar(inst, usarHeuristica);
+    auto dono = [&](const ChaveEstado &chave)
+    { return static_cast<int>((hashChave(chave) >> 32) % trabalhadores); };
+
+    const int SEM_SOLUCAO = numeric_limits<int>::max();
+    vector<TabelaChaves<InfoHDA>> tabelas(trabalhadores);
+    vector<CaixaMensagens<MensagemHDA>> caixas(trabalhadores);
+    unique_ptr<atomic<bool>[]> ociosos(new atomic<bool>[trabalhadores]);
+    atomic<long long> emTransito(0), atividade(0), nosExpandidos(0);
+    atomic<size_t> maiorAberta(0); // soma dos picos das listas abertas locais
+    atomic<int> incumbente(SEM_SOLUCAO);
+    atomic<bool> terminar(false), interrompida(false);
+    const ControleBusca *controle = controleAtual;
+    // Com limite de nós, cada expansão reserva antes a sua vaga no orçamento
+    // comum, para os trabalhadores juntos pararem exatamente no limite
+    const bool limitado = controle && controle->limiteNos > 0;
+    atomic<long long> reservadas(0);
+
+    for (int id = 0; id < trabalhadores; ++id)
+        ociosos[id] = true;
+    int donoInicial = dono(chaveInicial);
+    ociosos[donoInicial] = false;
+
+    auto atualizarIncumbente = [&](int custo)
+    {
+        int atual = incumbente.load();
+        while (custo < atual && !incumbente.compare_exchange_weak(atual, custo))
+        {
+        }
+    };
+
+    auto trabalhador = [&](int id)
+    {
+        TabelaChaves<InfoHDA> &tabela = tabelas[id];
+        priority_queue<EntradaAberta> aberta;
+        vector<vector<MensagemHDA>> saidas(trabalhadores);
+        vector<MensagemHDA> recebidas;
+        vector<int> estadoAtual(n), novoEstado(n);
+        long long expandidosLocal = 0;
+        size_t maiorAbertaLocal = 0;
+
+        auto receber = [&](const MensagemHDA &mensagem)
+        {
+            if (mensagem.g + mensagem.h >= incumbente.load(memory_order_relaxed))
+                return;
+            auto [info, novo] = tabela.inserir(mensagem.estado, {mensagem.pai, mensagem.g, false});
+            if (!novo)
+            {
+                if (mensagem.g >= info->g)
+                    return;
+                info->pai = mensagem.pai;
+                info->g = mensagem.g;
+                info->fechado = false; // reabre o estado com o custo menor
+            }
+            if (mensagem.estado == chaveObjetivo)
+                atualizarIncumbente(mensagem.g);
+            aberta.push({mensagem.g + mensagem.h, mensagem.g, mensagem.estado});
+            maiorAbertaLocal = max(maiorAbertaLocal, aberta.size());
+        };
+
+        if (id == donoInicial)
+            receber({chaveInicial, chaveInicial, 0, avaliar(estadoInicial.data())});
+
+        long long voltas = 0;
+        while (!terminar.load())
+        {
+            if (deveInterromper(controle, ++voltas, reservadas.load(memory_order_relaxed)))
+            {
+                interrompida = true;
+                terminar = true;
+                break;
+            }
+
+            // 1. Recebe os lotes enviados pelos outros trabalhadores
+            recebidas.clear();
+            size_t quantidade = caixas[id].retirarTodas(recebidas);
+            if (quantidade > 0)
+            {
+                ociosos[id] = false;
+                atividade++;
+                for (const MensagemHDA &mensagem : recebidas)
+                    receber(mensagem);
+                emTransito -= static_cast<long long>(quantidade);
+            }
+
+            // 2. Expande alguns nós da lista aberta local
+            for (int passo = 0; passo < 64 && !aberta.empty(); ++passo)
+            {
+                EntradaAberta entrada = aberta.top();
+                if (entrada.f >= incumbente.load(memory_order_relaxed))
+                    break;
+                aberta.pop();
+                InfoHDA *info = tabela.buscar(entrada.chave);
+                if (info->fechado || info->g != entrada.g)
+                    continue; // entrada obsoleta
+                if (limitado && reservadas.fetch_add(1) >= controle->limiteNos)
+                {
+                    aberta.push(entrada); // não expandida
+                    interrompida = true;
+                    terminar = true;
+                    break;
+                }
+                info->fechado = true;
+                expandidosLocal++;
+                if (entrada.chave == chaveObjetivo)
+                    continue;
+
+                codificador.decodificar(entrada.chave, estadoAtual.data());
+                for (const Movimento &mov : movimentos)
+                {
+                    novoEstado = estadoAtual;
+                    aplicarMovimento(inst, novoEstado.data(), mov);
+                    ChaveEstado chave = codificador.codificar(novoEstado.data());
+                    if (chave == entrada.chave)
+                        continue;
+                    int h = avaliar(novoEstado.data());
+                    if (h >= HEURISTICA_INFINITA || entrada.g + 1 + h >= incumbente.load(memory_order_relaxed))
+                        continue;
+                    MensagemHDA mensagem{chave, entrada.chave, entrada.g + 1, h};
+                    int destino = dono(chave);
+                    if (destino == id)
+                        receber(mensagem);
+                    else
+                        saidas[destino].push_back(mensagem);
+                }
+            }
+
+            // 3. Envia os lotes acumulados (contados em trânsito antes do envio)
+            for (int destino = 0; destino < trabalhadores; ++destino)
+            {
+                if (saidas[destino].empty())
+                    continue;
+                emTransito += static_cast<long long>(saidas[destino].size());
+                caixas[destino].enviar(move(saidas[destino]));
+                saidas[destino].clear();
+            }
+
+            // 4. Sem trabalho útil: fica ocioso e verifica o término global
+            if (aberta.empty() || aberta.top().f >= incumbente.load())
+            {
+                ociosos[id] = true;
+                long long antes = atividade.load();
+                bool todosOciosos = emTransito.load() == 0;
+                for (int outro = 0; outro < trabalhadores && todosOciosos; ++outro)
+                    todosOciosos = ociosos[outro].load();
+                if (todosOciosos && emTransito.load() == 0 && atividade.load() == antes)
+                    terminar = true;
+                else
+                    this_thread::yield();
+            }
+        }
+        nosExpandidos += expandidosLocal;
+        maiorAberta += maiorAbertaLocal;
+    };
+
+    auto start = high_resolution_clock::now();
+    {
+        PoolThreads pool(trabalhadores);
+        pool.executar(trabalhador);
+    }
+
+    ResultadoBusca resultado;
+    resultado.tempoMicros = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    resultado.metodo = metodo;
+    resultado.threads = trabalhadores;
+    resultado.nosExpandidos = static_cast<int>(nosExpandidos.load());
+    for (const auto &tabela : tabelas)
+        resultado.nosVisitados += static_cast<int>(tabela.size());
+    resultado.metricas.expandidos = nosExpandidos.load();
+    resultado.metricas.maiorVisitados = static_cast<size_t>(resultado.nosVisitados);
+    resultado.metricas.maiorAberta = maiorAberta.load();
+    // Se a busca foi interrompida, a melhor solução encontrada não é garantidamente ótima
+    resultado.interrompida = interrompida.load();
+    resultado.encontrou = incumbente.load() != SEM_SOLUCAO && !resultado.interrompida;
+    if (!resultado.encontrou)
+        return resultado;
+
+    // Reconstrói o caminho seguindo os pais guardados nas tabelas dos donos
+    vector<int> niveis(n);
+    for (ChaveEstado chave = chaveObjetivo;; chave = tabelas[dono(chave)].buscar(chave)->pai)
+    {
+        codificador.decodificar(chave, niveis.data());
+        resultado.caminho.push_back(niveis);
+        if (chave == chaveInicial)
+            break;
+    }
+    reverse(resultado.caminho.begin(), resultado.caminho.end());
+    // Os pais podem ter sido trocados depois que o incumbente foi fixado
+    // (heurística inconsistente), então o custo vem do caminho refeito
+    resultado.custo = static_cast<int>(resultado.caminho.size()) - 1;
+    return resultado;
+}
+
+// Entrada da tabela de transposição do IDA*: menor g com que o estado foi
+// alcançado na iteração indicada
+struct EntradaTransposicao
+{
+    ChaveEstado chave;
+    int g = 0;
+    int iteracao = -1;
+};
+
+// Função de Busca IDA* (A* com aprofundamento iterativo): busca em
+// profundidade limitada por f = g + h, com o limite subindo a cada iteração
+// para o menor f que o excedeu. A pilha explícita guarda só o movimento de
+// cada nível, e os níveis são alterados e desfeitos em um único vetor, então
+// a memória é linear na profundidade. A tabela de transposição opcional é de
+// tamanho fixo (mapeamento direto) e corta ramos que chegam a um estado já
+// visto na mesma iteração com g menor ou igual. O banco de padrões só é usado
+// se couber em LIMITE_BANCO_IDA; senão a heurística é a soma das diferenças.
+const size_t LIMITE_BANCO_IDA = static_cast<size_t>(2) << 20;
+
+ResultadoBusca buscaIDAEstrela(const vector<Capacidade> &jarros, bool usarTabela)
+{
+    Instancia inst = criarInstancia(jarros);
+    CodificadorEstado codificador(inst);
+    vector<Movimento> movimentos = listarMovimentos(inst.n);
+    int totalMovimentos = static_cast<int>(movimentos.size());
+    usarTabela = usarTabela && codificador.cabe();
+
+    const size_t tamanhoTabela = static_cast<size_t>(1) << 16;
+    vector<EntradaTransposicao> tabela(usarTabela ? tamanhoTabela : 0);
+
+    // Um caminho mínimo nunca é maior que o número de estados
+    double totalEstados = 1;
+    for (int capacidade : inst.capacidadeMax)
+        totalEstados *= capacidade + 1.0;
+
+    struct Quadro
+    {
+        int g = 0;
+        int proximo = 0;    // próximo movimento a tentar
+        int movimento = -1; // movimento que levou a este nível
+        // Desfazer o movimento que levou a este nível
+        int de = 0, para = 0, antigoDe = 0, antigoPara = 0;
+    };
+
+    vector<int> niveis = converterEstado(jarros);
+    vector<int> limites;
+    vector<Quadro> pilha;
+    long long nosExpandidos = 0, nosGerados = 0, expandidosUltima = 0, cortesTabela = 0, reexpansoesTabela = 0;
+    size_t entradasOcupadas = 0; // entradas da tabela de transposição já usadas
+    bool encontrou = false;
+
+    auto start = high_resolution_clock::now();
+
+    Heuristica avaliar(inst, true, true, LIMITE_BANCO_IDA);
+    MonitorBusca monitor(usarTabela ? "IDA* (com tabela de transposicao)" : "IDA*");
+    int hInicial = avaliar(niveis.data());
+    int limite = hInicial;
+
+    const ControleBusca *controle = controleAtual;
+    bool interrompida = false;
+    long long iteracoes = 0;
+
+    while (!encontrou && !interrompida && limite < HEURISTICA_INFINITA && limite < totalEstados)
+    {
+        limites.push_back(limite);
+        int iteracao = static_cast<int>(limites.size()) - 1;
+        int proximoLimite = HEURISTICA_INFINITA;
+        expandidosUltima = 0;
+
+        pilha.assign(1, Quadro());
+        nosExpandidos++;
+        expandidosUltima++;
+        monitor.expandido(1, entradasOcupadas);
+        if (atingiuObjetivos(inst, niveis.data()))
+        {
+            encontrou = true;
+            break;
+        }
+
+        while (!pilha.empty())
+        {
+            if (deveInterromper(controle, ++iteracoes, nosExpandidos))
+            {
+                interrompida = true;
+                break;
+            }
+            MedidorFase medidor(monitor, FASE_EXPANSAO);
+
+            Quadro &topo = pilha.back();
+            if (topo.proximo == totalMovimentos)
+            {
+                // Todos os filhos tentados: desfaz o movimento e volta um nível
+                // (a raiz não veio de movimento nenhum, não há o que desfazer)
+                if (topo.movimento >= 0)
+                {
+                    niveis[topo.de] = topo.antigoDe;
+                    niveis[topo.para] = topo.antigoPara;
+                }
+                pilha.pop_back();
+                continue;
+            }
+
+            const Movimento &mov = movimentos[topo.proximo++];
+            Quadro filho;
+            filho.movimento = topo.proximo - 1;
+            filho.g = topo.g + 1;
+            filho.de = mov.de;
+            filho.para = mov.para;
+            filho.antigoDe = niveis[mov.de];
+            filho.antigoPara = niveis[mov.para];
+            if (aplicarMovimento(inst, niveis.data(), mov) == 0)
+                continue; // movimento sem efeito
+            nosGerados++;
+            monitor.gerado();
+
+            int h = avaliar(niveis.data());
+            int f = filho.g + h;
+            bool cortar = h >= HEURISTICA_INFINITA;
+            if (!cortar && f > limite)
+            {
+                proximoLimite = min(proximoLimite, f);
+                cortar = true;
+            }
+            if (!cortar && usarTabela)
+            {
+                MedidorFase consulta(monitor, FASE_CONSULTA);
+                ChaveEstado chave = codificador.codificar(niveis.data());
+                EntradaTransposicao &entrada = tabela[hashChave(chave) & (tamanhoTabela - 1)];
+                bool mesmoEstado = entrada.iteracao == iteracao && entrada.chave == chave;
+                if (mesmoEstado && entrada.g <= filho.g)
+                {
+                    cortesTabela++;
+                    monitor.duplicado();
+                    cortar = true;
+                }
+                else
+                {
+                    if (mesmoEstado)
+                        reexpansoesTabela++; // mesmo estado, agora com g menor
+                    if (entrada.iteracao < 0)
+                        entradasOcupadas++;
+                    entrada = {chave, filho.g, iteracao};
+                }
+            }
+            if (cortar)
+            {
+                niveis[filho.de] = filho.antigoDe;
+                niveis[filho.para] = filho.antigoPara;
+                continue;
+            }
+
+            nosExpandidos++;
+            expandidosUltima++;
+            {
+                MedidorFase fila(monitor, FASE_FILA);
+                pilha.push_back(filho);
+            }
+            monitor.expandido(pilha.size(), entradasOcupadas);
+            if (atingiuObjetivos(inst, niveis.data()))
+            {
+                encontrou = true;
+                break;
+            }
+        }
+        limite = proximoLimite;
+    }
+
+    ResultadoBusca resultado;
+    resultado.tempoMicros = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    resultado.metodo = usarTabela ? "IDA* (com tabela de transposicao)" : "IDA*";
+    resultado.nosExpandidos = static_cast<int>(nosExpandidos);
+    resultado.nosVisitados = static_cast<int>(nosGerados);
+    resultado.encontrou = encontrou;
+    resultado.interrompida = interrompida;
+    resultado.metricas = monitor.finalizar(tabela.capacity() * sizeof(EntradaTransposicao) + pilha.capacity() * sizeof(Quadro));
+    // Sem conjunto de visitados, toda expansão repetida de uma iteração anterior
+    // ou com g menor na mesma iteração conta como reabertura
+    resultado.metricas.reabertos = nosExpandidos - expandidosUltima + reexpansoesTabela;
+
+    string textoLimites;
+    for (int valor : limites)
+        textoLimites += (textoLimites.empty() ? "" : " ") + to_string(valor);
+    resultado.detalhes.push_back({"Heuristica", avaliar.admissivel() ? "banco de padroes" : "soma das diferencas"});
+    resultado.detalhes.push_back({"Iteracoes", to_string(limites.size())});
+    resultado.detalhes.push_back({"Limites de f", textoLimites});
+    resultado.detalhes.push_back({"Reexpansoes de iteracoes anteriores", to_string(nosExpandidos - expandidosUltima)});
+    if (usarTabela)
+    {
+        resultado.detalhes.push_back({"Cortes pela tabela de transposicao", to_string(cortesTabela)});
+        resultado.detalhes.push_back({"Reexpansoes com g menor na mesma iteracao", to_string(reexpansoesTabela)});
+    }
+    if (!encontrou)
+        return resultado;
+
+    // A pilha guarda o caminho: reaplica os movimentos a partir do início
+    resultado.caminho.push_back(converterEstado(jarros));
+    for (size_t nivel = 1; nivel < pilha.size(); ++nivel)
+    {
+        vector<int> estado = resultado.caminho.back();
+        aplicarMovimento(inst, estado.data(), movimentos[pilha[nivel].movimento]);
+        resultado.caminho.push_back(estado);
+    }
+    resultado.custo = static_cast<int>(pilha.size()) - 1;
+    return resultado;
+}
+
+// Gravação sequencial de chaves em arquivo, empacotadas com apenas os bytes
+// necessários para os bits do estado, por meio de um buffer próprio
+class ArquivoEstadosSaida
+{
+public:
+    ArquivoEstadosSaida(const string &caminho, int bytesPorEstado, size_t bytesBuffer)
+        : arquivo(caminho, ios::binary | ios::trunc), bytesPorEstado(bytesPorEstado)
+    {
+        buffer.reserve(max(bytesBuffer, static_cast<size_t>(4096)));
+    }
+
+    ~ArquivoEstadosSaida() { fechar(); }
+
+    bool aberto() const { return arquivo.is_open(); }
+    // Verdadeiro se a abertura, alguma gravação ou o fechamento falhou
+    bool falhou() const { return !arquivo; }
+
+    void escrever(const ChaveEstado &chave)
+    {
+        for (int b = 0; b < bytesPorEstado; ++b)
+            buffer.push_back(static_cast<char>((b < 8 ? chave.baixo >> (8 * b) : chave.alto >> (8 * (b - 8))) & 0xff));
+        quantidadeEstados++;
+        if (buffer.size() + bytesPorEstado > buffer.capacity())
+            descarregar();
+    }
+
+    void fechar()
+    {
+        if (!arquivo.is_open())
+            return;
+        descarregar();
+        arquivo.close();
+    }
+
+    size_t quantidade() const { return quantidadeEstados; }
+    size_t bytesGravados() const { return quantidadeEstados * bytesPorEstado; }
+
+private:
+    ofstream arquivo;
+    int bytesPorEstado;
+    vector<char> buffer;
+    size_t quantidadeEstados = 0;
+
+    void descarregar()
+    {
+        arquivo.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+        buffer.clear();
+    }
+};
+
+// Leitura sequencial de um arquivo gravado por ArquivoEstadosSaida
+class ArquivoEstadosEntrada
+{
+public:
+    ArquivoEstadosEntrada(const string &caminho, int bytesPorEstado, size_t bytesBuffer)
+        : arquivo(caminho, ios::binary), bytesPorEstado(bytesPorEstado)
+    {
+        size_t estados = max(bytesBuffer / bytesPorEstado, static_cast<size_t>(256));
+        buffer.resize(estados * bytesPorEstado);
+    }
+
+    bool aberto() const { return arquivo.is_open(); }
+    // Erro de leitura (o fim do arquivo não conta)
+    bool falhou() const { return arquivo.bad(); }
+
+    // Lê a próxima chave; retorna false no fim do arquivo ou se o último
+    // registro estiver incompleto (arquivo truncado)
+    bool ler(ChaveEstado &chave)
+    {
+        if (posicao == usados)
+        {
+            arquivo.read(buffer.data(), static_cast<streamsize>(buffer.size()));
+            usados = static_cast<size_t>(arquivo.gcount());
+            posicao = 0;
+            bytesLidos += usados;
+            if (usados == 0)
+                return false;
+        }
+        if (usados - posicao < static_cast<size_t>(bytesPorEstado))
+        {
+            posicao = usados;
+            return false;
+        }
+        chave = ChaveEstado();
+        for (int b = 0; b < bytesPorEstado; ++b)
+        {
+            uint64_t valor = static_cast<unsigned char>(buffer[posicao++]);
+            if (b < 8)
+                chave.baixo |= valor << (8 * b);
+            else
+                chave.alto |= valor << (8 * (b - 8));
+        }
+        return true;
+    }
+
+    size_t lidos() const { return bytesLidos; }
+
+private:
+    ifstream arquivo;
+    int bytesPorEstado;
+    vector<char> buffer;
+    size_t posicao = 0, usados = 0, bytesLidos = 0;
+};
+
+// Função de Busca em Largura em memória externa: cada nível da fronteira fica
+// em disco como um arquivo de chaves ordenadas e empacotadas. Os sucessores
+// de um nível são acumulados em um buffer limitado pela memória configurada;
+// cada buffer cheio é ordenado e gravado como uma sequência (run). Depois, uma
+// única intercalação sequencial das sequências com o arquivo ordenado de
+// todos os estados já vistos elimina as duplicatas (detecção atrasada, sem
+// consulta por nó) e grava o próximo nível e o novo arquivo de vistos.
+//
+// Como encher e esvaziar não têm volta, um estado pode reaparecer muitos
+// níveis depois de visto, por isso a comparação é com todos os níveis
+// anteriores e não só com os dois últimos. O custo disso é que cada nível lê
+// e regrava o arquivo inteiro de vistos: com N estados alcançáveis e
+// profundidade D, a entrada e saída total é O(N * D) e não O(N). O caminho é
+// reconstruído do objetivo para trás: em cada nível guardado procura-se, por
+// intercalação, um dos predecessores do estado atual.
+//
+// Qualquer falha de disco (diretório, abertura, gravação ou leitura) encerra a
+// busca com o detalhe "Erro", em vez de um "sem solução" que não foi provado.
+ResultadoBusca buscaEmLarguraExterna(const vector<Capacidade> &jarros)
+{
+    Instancia inst = criarInstancia(jarros);
+    CodificadorEstado codificador(inst);
+    if (!codificador.cabe())
+    {
+        ResultadoBusca resultado = buscaEmLargura(jarros);
+        resultado.metodo = "Busca em Largura (estado nao cabe em 128 bits)";
+        return resultado;
+    }
+
+    int n = inst.n;
+    int bytesPorEstado = (codificador.bitsTotais() + 7) / 8;
+    size_t memoria = max(configuracao.memoriaBfsExterna, static_cast<size_t>(1) << 16);
+    size_t capacidadeBuffer = memoria / 2 / sizeof(ChaveEstado); // metade para os sucessores
+    size_t bytesEntradaSaida = memoria / 2;                        // metade para os buffers de arquivo
+
+    // Diretório próprio para os arquivos desta busca
+    static atomic<int> contadorBuscas(0);
+    error_code erro;
+    filesystem::path base = configuracao.diretorioBfsExterna.empty() ? filesystem::temp_directory_path(erro)
+                                                                     : filesystem::path(configuracao.diretorioBfsExterna);
+    filesystem::path pasta = base / ("jarro_bfs_" + to_string(high_resolution_clock::now().time_since_epoch().count()) +
+                                     "_" + to_string(contadorBuscas++));
+    // Primeira falha de disco; a busca para assim que ela é registrada
+    string erroDisco;
+    if (!erro)
+        filesystem::create_directories(pasta, erro);
+    if (erro)
+        erroDisco = "nao foi possivel criar o diretorio " + pasta.string() + ": " + erro.message();
+    auto verificarSaida = [&](const ArquivoEstadosSaida &arquivo, const string &caminho)
+    {
+        if (erroDisco.empty() && arquivo.falhou())
+            erroDisco = "falha ao gravar " + caminho;
+    };
+    auto verificarEntrada = [&](const ArquivoEstadosEntrada &arquivo, const string &caminho)
+    {
+        if (erroDisco.empty() && (!arquivo.aberto() || arquivo.falhou()))
+            erroDisco = "falha ao ler " + caminho;
+    };
+    auto arquivoNivel = [&](int nivel)
+    { return (pasta / ("nivel_" + to_string(nivel) + ".bin")).string(); };
+    auto arquivoVistos = [&](int geracao)
+    { return (pasta / ("vistos_" + to_string(geracao % 2) + ".bin")).string(); };
+
+    auto start = high_resolution_clock::now();
+    MonitorBusca monitor("Busca em Largura Externa");
+    const ControleBusca *controle = controleAtual;
+    GeradorSucessores gerador(inst, false);
+
+    vector<int> estadoInicial = converterEstado(jarros), estadoAtual(n);
+    ChaveEstado chaveInicial = codificador.codificar(estadoInicial.data());
+    bool objetivoValido = objetivoCabe(inst);
+    // Objetivo inválido: nenhuma chave o representa e a busca não começa
+    ChaveEstado chaveObjetivo = objetivoValido ? codificador.codificar(inst.objetivo.data()) : ChaveEstado{~0ULL, ~0ULL};
+
+    if (erroDisco.empty())
+    {
+        ArquivoEstadosSaida nivel0(arquivoNivel(0), bytesPorEstado, 4096), vistos0(arquivoVistos(0), bytesPorEstado, 4096);
+        nivel0.escrever(chaveInicial);
+        vistos0.escrever(chaveInicial);
+        nivel0.fechar();
+        vistos0.fechar();
+        verificarSaida(nivel0, arquivoNivel(0));
+        verificarSaida(vistos0, arquivoVistos(0));
+    }
+
+    size_t totalVistos = 1, tamanhoNivel = 1, maiorNivel = 1;
+    size_t bytesGravados = 2 * static_cast<size_t>(bytesPorEstado), bytesLidos = 0;
+    long long totalSequencias = 0, nanosOrdenacao = 0, nanosIntercalacao = 0;
+    int profundidade = 0, nosExpandidos = 0;
+    bool encontrou = chaveInicial == chaveObjetivo, interrompida = false;
+    vector<ChaveEstado> sucessores;
+    sucessores.reserve(min(capacidadeBuffer, static_cast<size_t>(1) << 20));
+
+    while (!encontrou && !interrompida && tamanhoNivel > 0 && objetivoValido && erroDisco.empty())
+    {
+        // Expansão: sucessores do nível em sequências ordenadas e sem repetição
+        vector<string> sequencias;
+        auto gravarSequencia = [&]
+        {
+            auto inicioOrdenacao = high_resolution_clock::now();
+            sort(sucessores.begin(), sucessores.end());
+            size_t gerados = sucessores.size();
+            sucessores.erase(unique(sucessores.begin(), sucessores.end()), sucessores.end());
+            monitor.duplicado(static_cast<long long>(gerados - sucessores.size())); // repetidos na sequência
+            sequencias.push_back((pasta / ("run_" + to_string(sequencias.size()) + ".bin")).string());
+            ArquivoEstadosSaida saida(sequencias.back(), bytesPorEstado, 1 << 16);
+            for (const ChaveEstado &chave : sucessores)
+                saida.escrever(chave);
+            saida.fechar();
+            verificarSaida(saida, sequencias.back());
+            bytesGravados += saida.bytesGravados();
+            sucessores.clear();
+            nanosOrdenacao += duration_cast<nanoseconds>(high_resolution_clock::now() - inicioOrdenacao).count();
+        };
+
+        {
+            ArquivoEstadosEntrada fronteira(arquivoNivel(profundidade), bytesPorEstado, 1 << 16);
+            ChaveEstado chave;
+            while (erroDisco.empty() && fronteira.ler(chave))
+            {
+                if (deveInterromper(controle, nosExpandidos, nosExpandidos))
+                {
+                    interrompida = true;
+                    break;
+                }
+                nosExpandidos++;
+                monitor.expandido(tamanhoNivel, totalVistos);
+                codificador.decodificar(chave, estadoAtual.data());
+                gerador.gerar(estadoAtual.data(), [&](const int *novoEstado)
+                              {
+                    monitor.gerado();
+                    sucessores.push_back(codificador.codificar(novoEstado));
+                    if (sucessores.size() >= capacidadeBuffer)
+                        gravarSequencia(); });
+            }
+            verificarEntrada(fronteira, arquivoNivel(profundidade));
+            bytesLidos += fronteira.lidos();
+        }
+        if (interrompida || !erroDisco.empty())
+            break;
+        if (!sucessores.empty())
+            gravarSequencia();
+        totalSequencias += static_cast<long long>(sequencias.size());
+
+        // Intercalação: sequências x vistos -> próximo nível e novos vistos
+        auto inicioIntercalacao = high_resolution_clock::now();
+        size_t bufferPorArquivo = bytesEntradaSaida / (sequencias.size() + 3);
+        vector<unique_ptr<ArquivoEstadosEntrada>> leitores;
+        using Cabeca = pair<ChaveEstado, size_t>; // menor chave de cada sequência
+        auto maior = [](const Cabeca &a, const Cabeca &b)
+        { return b.first < a.first; };
+        priority_queue<Cabeca, vector<Cabeca>, decltype(maior)> cabecas(maior);
+        for (size_t s = 0; s < sequencias.size(); ++s)
+        {
+            leitores.push_back(make_unique<ArquivoEstadosEntrada>(sequencias[s], bytesPorEstado, bufferPorArquivo));
+            verificarEntrada(*leitores.back(), sequencias[s]);
+            ChaveEstado chave;
+            if (leitores.back()->ler(chave))
+                cabecas.push({chave, s});
+        }
+
+        ArquivoEstadosEntrada vistos(arquivoVistos(profundidade), bytesPorEstado, bufferPorArquivo);
+        ArquivoEstadosSaida proximoNivel(arquivoNivel(profundidade + 1), bytesPorEstado, bufferPorArquivo);
+        ArquivoEstadosSaida novosVistos(arquivoVistos(profundidade + 1), bytesPorEstado, bufferPorArquivo);
+        ChaveEstado visto, anterior;
+        bool temVisto = vistos.ler(visto), temAnterior = false;
+        while (!cabecas.empty())
+        {
+            auto [chave, origem] = cabecas.top();
+            cabecas.pop();
+            ChaveEstado seguinte;
+            if (leitores[origem]->ler(seguinte))
+                cabecas.push({seguinte, origem});
+            if (temAnterior && anterior == chave)
+            {
+                monitor.duplicado(); // repetido entre sequências
+                continue;
+            }
+            anterior = chave;
+            temAnterior = true;
+
+            while (temVisto && visto < chave)
+            {
+                novosVistos.escrever(visto);
+                temVisto = vistos.ler(visto);
+            }
+            if (temVisto && visto == chave)
+            {
+                monitor.duplicado(); // já visto em um nível anterior
+                continue;
+            }
+            proximoNivel.escrever(chave);
+            novosVistos.escrever(chave);
+            if (chave == chaveObjetivo)
+                encontrou = true;
+        }
+        while (temVisto)
+        {
+            novosVistos.escrever(visto);
+            temVisto = vistos.ler(visto);
+        }
+        proximoNivel.fechar();
+        novosVistos.fechar();
+        verificarEntrada(vistos, arquivoVistos(profundidade));
+        verificarSaida(proximoNivel, arquivoNivel(profundidade + 1));
+        verificarSaida(novosVistos, arquivoVistos(profundidade + 1));
+        bytesLidos += vistos.lidos();
+        bytesGravados += proximoNivel.bytesGravados() + novosVistos.bytesGravados();
+        for (size_t s = 0; s < sequencias.size(); ++s)
+        {
+            verificarEntrada(*leitores[s], sequencias[s]);
+            bytesLidos += leitores[s]->lidos();
+            leitores[s].reset();
+            filesystem::remove(sequencias[s], erro);
+        }
+        nanosIntercalacao += duration_cast<nanoseconds>(high_resolution_clock::now() - inicioIntercalacao).count();
+        if (!erroDisco.empty())
+        {
+            encontrou = false; // o nível gravado pode estar incompleto
+            break;
+        }
+
+        profundidade++;
+        tamanhoNivel = proximoNivel.quantidade();
+        totalVistos = novosVistos.quantidade();
+        maiorNivel = max(maiorNivel, tamanhoNivel);
+    }
+
+    ResultadoBusca resultado;
+    resultado.metodo = "Busca em Largura Externa";
+    resultado.nosVisitados = static_cast<int>(min(totalVistos, static_cast<size_t>(numeric_limits<int>::max())));
+    resultado.nosExpandidos = nosExpandidos;
+    resultado.encontrou = encontrou;
+    resultado.interrompida = interrompida;
+    if (!erroDisco.empty())
+        resultado.detalhes.push_back({"Erro", erroDisco});
+
+    if (encontrou)
+    {
+        // Do objetivo para trás: um predecessor do estado atual no nível anterior
+        vector<ChaveEstado> caminho = {chaveObjetivo};
+        vector<int> predecessores;
+        vector<ChaveEstado> candidatos;
+        for (int nivel = profundidade - 1; nivel >= 0 && resultado.encontrou; --nivel)
+        {
+            codificador.decodificar(caminho.back(), estadoAtual.data());
+            predecessores.clear();
+            gerarPredecessores(inst, estadoAtual.data(), predecessores);
+            candidatos.clear();
+            for (size_t p = 0; p < predecessores.size(); p += n)
+                candidatos.push_back(codificador.codificar(&predecessores[p]));
+            sort(candidatos.begin(), candidatos.end());
+
+            ArquivoEstadosEntrada arquivo(arquivoNivel(nivel), bytesPorEstado, bytesEntradaSaida);
+            ChaveEstado chave;
+            size_t c = 0;
+            bool achou = false;
+            while (!achou && c < candidatos.size() && arquivo.ler(chave))
+            {
+                while (c < candidatos.size() && candidatos[c] < chave)
+                    c++;
+                achou = c < candidatos.size() && candidatos[c] == chave;
+            }
+            bytesLidos += arquivo.lidos();
+            if (!arquivo.aberto() || arquivo.falhou())
+            {
+                resultado.encontrou = false;
+                resultado.detalhes.push_back({"Erro", "falha ao ler " + arquivoNivel(nivel)});
+                break;
+            }
+            if (!achou)
+            {
+                // Só acontece com o arquivo do nível corrompido ou truncado
+                resultado.encontrou = false;
+                resultado.interrompida = true;
+                resultado.detalhes.push_back({"Erro", "nenhum predecessor no arquivo do nivel " + to_string(nivel) +
+                                                          " (arquivo corrompido ou truncado)"});
+                break;
+            }
+            caminho.push_back(candidatos[c]);
+        }
+        if (resultado.encontrou)
+        {
+            reverse(caminho.begin(), caminho.end());
+            for (const ChaveEstado &chave : caminho)
+            {
+                codificador.decodificar(chave, estadoAtual.data());
+                resultado.caminho.push_back(estadoAtual);
+            }
+            resultado.custo = profundidade;
+        }
+    }
+
+    filesystem::remove_all(pasta, erro);
+    resultado.tempoMicros = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    resultado.metricas = monitor.finalizar(capacidadeBuffer * sizeof(ChaveEstado) + bytesEntradaSaida);
+    resultado.metricas.maiorVisitados = totalVistos;
+    resultado.detalhes.push_back({"Niveis gravados", to_string(profundidade + 1)});
+    resultado.detalhes.push_back({"Maior nivel", to_string(maiorNivel) + " estados"});
+    resultado.detalhes.push_back({"Sequencias ordenadas gravadas", to_string(totalSequencias)});
+    resultado.detalhes.push_back({"Bytes por estado", to_string(bytesPorEstado)});
+    resultado.detalhes.push_back({"Bytes gravados / lidos", to_string(bytesGravados) + " / " + to_string(bytesLidos)});
+    resultado.detalhes.push_back({"Tempo de ordenacao e gravacao", to_string(nanosOrdenacao / 1000000) + " ms"});
+    resultado.detalhes.push_back({"Tempo de intercalacao", to_string(nanosIntercalacao / 1000000) + " ms"});
+    resultado.detalhes.push_back({"Limite de memoria", to_string(memoria >> 20) + " MB"});
+    return resultado;
+}
+
+// Nó da busca de fronteira: operadores já usados (cada bit é um movimento que
+// não deve mais ser aplicado a partir do estado, porque o resultado já foi
+// tratado), camada do nó, se ele já foi expandido, predecessores que ainda
+// podem gerá-lo (antes da expansão, menos os que já o geraram) e o estado da
+// camada de retransmissão no caminho até ele
+struct NoFronteira
+{
+    uint64_t usados = 0;
+    int camada = -1;
+    bool fechado = false;
+    int pendentes = 0;
+    ChaveEstado retransmissao;
+};
+
+// Busca de fronteira em largura (Korf): sem lista de fechados, os bits de
+// operadores usados impedem que os vizinhos gerem de novo um nó expandido. Ao
+// expandir um nó, cada sucessor aberto recebe o bit do operador que levaria de
+// volta a ele. Como os movimentos não são reversíveis, sobram predecessores
+// que não são sucessores e ainda podem gerá-lo, talvez muitas camadas depois.
+// Em vez de guardá-los como nós fantasmas (que nunca saem se forem
+// inalcançáveis), o nó fechado guarda quantos deles faltam: os predecessores
+// possíveis, contados sem enumerá-los, menos os que já o geraram e os que
+// receberam o bit. Cada um que faltava, ao ser expandido, o encontra na
+// tabela e desconta um, e o nó sai quando a conta chega a zero. Todo estado
+// alcançável diferente do inicial tem algum jarro vazio ou cheio, então
+// predecessores sem isso não contam.
+//
+// A tabela fica com as camadas abertas e os fechados que ainda podem ser
+// gerados, nunca mais que a BFS, e nenhum estado é expandido duas vezes, o que
+// garante o término mesmo com ciclos. O caminho é refeito por divisão e
+// conquista: cada nó herda o estado da camada do meio do seu caminho, e as
+// duas metades são resolvidas de novo do mesmo jeito.
+class BuscaFronteira
+{
+public:
+    BuscaFronteira(const Instancia &inst, const CodificadorEstado &codificador)
+        : inst(inst), codificador(codificador), gerador(inst, false), movimentos(gerador.movimentos()),
+          indiceMovimento(3 * inst.n * inst.n, -1), monitor("Busca de Fronteira"), atual(inst.n), vizinho(inst.n)
+    {
+        for (size_t m = 0; m < movimentos.size(); ++m)
+            indiceMovimento[codigo(movimentos[m])] = static_cast<int>(m);
+    }
+
+    static bool suporta(const Instancia &inst) { return listarMovimentos(inst.n).size() <= 64; }
+
+    // Profundidade de 'destino' a partir de 'origem' (-1 = inalcançável, -2 =
+    // interrompida). Com 'camadaRetransmissao' >= 0, 'meio' recebe o estado
+    // daquela camada em um caminho ótimo.
+    int buscar(const ChaveEstado &origem, const ChaveEstado &destino, int camadaRetransmissao, ChaveEstado &meio)
+    {
+        TabelaChaves<NoFronteira> tabela;
+        vector<ChaveEstado> camada = {origem}, proxima;
+        codificador.decodificar(origem, atual.data());
+        divisor = 0;
+        for (int i = 0; i < inst.n; ++i)
+            divisor = gcd(gcd(divisor, inst.capacidadeMax[i]), atual[i]);
+        divisor = max(divisor, 1);
+        origemAlcancavel = podeSerAlcancado(atual.data());
+        NoFronteira raiz;
+        raiz.camada = 0;
+        raiz.retransmissao = origem;
+        tabela.inserir(origem, raiz);
+        reais++;
+        if (origem == destino)
+        {
+            meio = origem;
+            return 0;
+        }
+
+        const ControleBusca *controle = controleAtual;
+        size_t retidos = 0; // fechados na tabela à espera de predecessores
+        for (int profundidade = 0; !camada.empty(); ++profundidade)
+        {
+            proxima.clear();
+            for (const ChaveEstado &chave : camada)
+            {
+                if (deveInterromper(controle, ++iteracoes, expandidos))
+                    return -2;
+                NoFronteira no = *tabela.buscar(chave);
+                expandidos++;
+                monitor.expandido(camada.size() + proxima.size(), tabela.size());
+                registrarPico(tabela, camada.size(), proxima.size(), retidos);
+                MedidorFase medidor(monitor, FASE_EXPANSAO);
+                codificador.decodificar(chave, atual.data());
+
+                // Sucessores pelos operadores ainda não usados; cada sucessor
+                // que recebe o bit de volta não gerará mais este nó
+                int bloqueados = 0;
+                for (size_t m = 0; m < movimentos.size(); ++m)
+                {
+                    if (((no.usados >> m) & 1) || gerador.movimentoNulo(atual.data(), movimentos[m]))
+                        continue;
+                    monitor.gerado();
+                    copy(atual.begin(), atual.end(), vizinho.begin());
+                    aplicarMovimento(inst, vizinho.data(), movimentos[m]);
+                    ChaveEstado chaveVizinho = codificador.codificar(vizinho.data());
+                    int volta = movimentoDeVolta(atual.data(), movimentos[m]);
+                    pair<NoFronteira *, bool> inserido;
+                    {
+                        MedidorFase consulta(monitor, FASE_CONSULTA);
+                        inserido = tabela.inserir(chaveVizinho, NoFronteira());
+                    }
+                    NoFronteira &filho = *inserido.first;
+                    bool fechado = filho.fechado;
+                    if (!fechado && volta >= 0)
+                    {
+                        filho.usados |= 1ULL << volta;
+                        bloqueados++;
+                    }
+                    // Este nó era um dos predecessores que o sucessor espera
+                    filho.pendentes--;
+                    if (!inserido.second)
+                    {
+                        monitor.duplicado();
+                        if (fechado && filho.pendentes == 0)
+                        {
+                            tabela.remover(chaveVizinho);
+                            retidos--;
+                        }
+                        continue;
+                    }
+                    MedidorFase fila(monitor, FASE_FILA);
+                    filho.camada = profundidade + 1;
+                    reais++;
+                    filho.retransmissao = profundidade + 1 == camadaRetransmissao ? chaveVizinho : no.retransmissao;
+                    proxima.push_back(chaveVizinho);
+                    if (chaveVizinho == destino)
+                    {
+                        meio = filho.retransmissao;
+                        return profundidade + 1;
+                    }
+                }
+
+                // Predecessores que ainda podem gerar este nó: os possíveis,
+                // menos os que já o geraram (descontados em 'pendentes') e os
+                // sucessores bloqueados acima. A origem pode não passar no
+                // filtro dos predecessores, mas gera toda a camada 1.
+                int possiveis = contarPredecessores(atual.data());
+                if (no.camada == 1 && !origemAlcancavel)
+                    possiveis++;
+                NoFronteira *fechado = tabela.buscar(chave);
+                fechado->fechado = true;
+                fechado->pendentes += possiveis - bloqueados;
+                if (fechado->pendentes > 0)
+                    retidos++;
+                else
+                    tabela.remover(chave);
+            }
+            camada.swap(proxima);
+        }
+        return -1;
+    }
+
+    // Acrescenta a 'caminho' os estados depois de 'origem' até 'destino', que estão a 'distancia' passos
+    bool reconstruir(const ChaveEstado &origem, const ChaveEstado &destino, int distancia, vector<ChaveEstado> &caminho)
+    {
+        if (distancia <= 1)
+        {
+            if (distancia == 1)
+                caminho.push_back(destino);
+            return true;
+        }
+        int metade = distancia / 2;
+        ChaveEstado meio;
+        if (buscar(origem, destino, metade, meio) != distancia)
+            return false;
+        subproblemas++;
+        return reconstruir(origem, meio, metade, caminho) && reconstruir(meio, destino, distancia - metade, caminho);
+    }
+
+    MonitorBusca &monitorBusca() { return monitor; }
+    long long nosExpandidos() const { return expandidos; }
+    long long nosReais() const { return reais; }
+    size_t maiorTabela() const { return picoNos; }
+    size_t maiorCamada() const { return picoCamada; }
+    size_t maiorMemoria() const { return picoBytes; }
+    void registrarEstatisticas(ResultadoBusca &resultado) const
+    {
+        resultado.detalhes.push_back({"Maior tabela (fronteira + fechados)", to_string(picoNos)});
+        resultado.detalhes.push_back({"Maior camada", to_string(picoCamada)});
+        resultado.detalhes.push_back({"Maximo de fechados retidos", to_string(picoRetidos)});
+        resultado.detalhes.push_back({"Buscas de reconstrucao", to_string(subproblemas)});
+        gerador.registrarEstatisticas(resultado);
+    }
+
+private:
+    const Instancia &inst;
+    const CodificadorEstado &codificador;
+    GeradorSucessores gerador;
+    vector<Movimento> movimentos;
+    vector<int> indiceMovimento; // (tipo, de, para) -> índice em 'movimentos'
+    MonitorBusca monitor;
+    vector<int> atual, vizinho;
+    long long iteracoes = 0, expandidos = 0, reais = 0, subproblemas = 0;
+    size_t picoNos = 0, picoCamada = 0, picoRetidos = 0, picoBytes = 0;
+    int divisor = 1;               // mdc das capacidades e dos níveis da origem da busca
+    bool origemAlcancavel = false; // a origem passa em podeSerAlcancado
+
+    size_t codigo(const Movimento &mov) const { return (static_cast<size_t>(mov.tipo) * inst.n + mov.de) * inst.n + mov.para; }
+
+    int indice(TipoMovimento tipo, int de, int para) const { return indiceMovimento[codigo({tipo, de, para})]; }
+
+    // Movimento que desfaz 'mov' aplicado sobre 'niveis' (-1 se nenhum desfaz)
+    int movimentoDeVolta(const int *niveis, const Movimento &mov) const
+    {
+        switch (mov.tipo)
+        {
+        case ENCHER:
+            return niveis[mov.de] == 0 ? indice(ESVAZIAR, mov.de, mov.de) : -1;
+        case ESVAZIAR:
+            return niveis[mov.de] == inst.capacidadeMax[mov.de] ? indice(ENCHER, mov.de, mov.de) : -1;
+        case TRANSFERIR:
+            // A volta devolve a mesma quantidade se ela esvaziar 'para' ou encher 'de'
+            return niveis[mov.para] == 0 || niveis[mov.de] == inst.capacidadeMax[mov.de] ? indice(TRANSFERIR, mov.para, mov.de) : -1;
+        }
+        return -1;
+    }
+
+    // Quantos predecessores de gerarPredecessores passam em podeSerAlcancado,
+    // sem enumerá-los: os jarros que o movimento não muda já são múltiplos do
+    // mdc, então basta contar os níveis múltiplos do mdc no jarro que muda e,
+    // se nenhum outro jarro estiver vazio ou cheio, só os que põem um jarro
+    // no limite
+    int contarPredecessores(const int *niveis) const
+    {
+        int limites = 0;
+        for (int i = 0; i < inst.n; ++i)
+            limites += niveis[i] == 0 || niveis[i] == inst.capacidadeMax[i] ? 1 : 0;
+        auto noLimite = [&](int i)
+        { return niveis[i] == 0 || niveis[i] == inst.capacidadeMax[i] ? 1 : 0; };
+
+        int total = 0;
+        for (int i = 0; i < inst.n; ++i)
+        {
+            bool outroLimite = limites - noLimite(i) > 0;
+            // Encher i: antes 0 até capacidade - 1; esvaziar i: antes 1 até capacidade
+            int niveisAntes = outroLimite ? inst.capacidadeMax[i] / divisor : min(inst.capacidadeMax[i], 1);
+            if (niveis[i] == inst.capacidadeMax[i])
+                total += niveisAntes;
+            if (niveis[i] == 0)
+                total += niveisAntes;
+
+            // Transferir q de i para j: antes i tinha q a mais e j q a menos
+            for (int j = 0; j < inst.n; ++j)
+            {
+                if (i == j || (niveis[i] != 0 && niveis[j] != inst.capacidadeMax[j]))
+                    continue;
+                int maximo = min(niveis[j], inst.capacidadeMax[i] - niveis[i]);
+                if (limites - noLimite(i) - noLimite(j) > 0)
+                {
+                    total += maximo / divisor;
+                    continue;
+                }
+                // Sem outro jarro no limite, i precisava estar cheio ou j vazio
+                int encheI = inst.capacidadeMax[i] - niveis[i], esvaziaJ = niveis[j];
+                auto valido = [&](int q)
+                { return q >= 1 && q <= maximo && q % divisor == 0; };
+                total += valido(encheI) ? 1 : 0;
+                total += esvaziaJ != encheI && valido(esvaziaJ) ? 1 : 0;
+            }
+        }
+        return total;
+    }
+
+    // Condições necessárias para o estado ser alcançado depois de algum
+    // movimento: algum jarro vazio ou cheio, e todos os níveis múltiplos do mdc
+    // das capacidades e dos níveis iniciais (encher, esvaziar e transferir
+    // preservam essa divisibilidade)
+    bool podeSerAlcancado(const int *niveis) const
+    {
+        bool limite = false;
+        for (int i = 0; i < inst.n; ++i)
+        {
+            if (niveis[i] % divisor != 0)
+                return false;
+            limite = limite || niveis[i] == 0 || niveis[i] == inst.capacidadeMax[i];
+        }
+        return limite;
+    }
+
+    void registrarPico(const TabelaChaves<NoFronteira> &tabela, size_t atual, size_t proxima, size_t retidos)
+    {
+        picoNos = max(picoNos, tabela.size());
+        picoCamada = max(picoCamada, max(atual, proxima));
+        picoRetidos = max(picoRetidos, retidos);
+        picoBytes = max(picoBytes, tabela.bytes() + (atual + proxima) * sizeof(ChaveEstado));
+    }
+};
+
+// Busca de fronteira: profundidade ótima e caminho guardando só as camadas
+// abertas. Sem chave compacta ou com mais de 64 movimentos, usa a BFS.
+ResultadoBusca buscaFronteira(const vector<Capacidade> &jarros)
+{
+    Instancia inst = criarInstancia(jarros);
+    CodificadorEstado codificador(inst);
+    if (!codificador.cabe() || !BuscaFronteira::suporta(inst))
+    {
+        ResultadoBusca resultado = buscaEmLargura(jarros);
+        resultado.metodo = "Busca em Largura (busca de fronteira nao se aplica)";
+        return resultado;
+    }
+
+    auto start = high_resolution_clock::now();
+    vector<int> estadoInicial = converterEstado(jarros);
+    ChaveEstado origem = codificador.codificar(estadoInicial.data());
+    // Objetivo inválido: a busca percorre tudo sem encontrá-lo
+    ChaveEstado destino = objetivoCabe(inst) ? codificador.codificar(inst.objetivo.data()) : ChaveEstado{~0ULL, ~0ULL};
+
+    BuscaFronteira busca(inst, codificador);
+    ChaveEstado meio;
+    int profundidade = busca.buscar(origem, destino, -1, meio);
+    long long expandidosPrimeira = busca.nosExpandidos(), visitadosPrimeira = busca.nosReais();
+
+    ResultadoBusca resultado;
+    resultado.metodo = "Busca de Fronteira";
+    resultado.interrompida = profundidade == -2;
+    vector<ChaveEstado> caminho = {origem};
+    if (profundidade >= 0)
+    {
+        if (busca.reconstruir(origem, destino, profundidade, caminho))
+        {
+            resultado.encontrou = true;
+            resultado.custo = profundidade;
+            vector<int> niveis(inst.n);
+            for (const ChaveEstado &chave : caminho)
+            {
+                codificador.decodificar(chave, niveis.data());
+                resultado.caminho.push_back(niveis);
+            }
+        }
+        else
+            resultado.interrompida = true;
+    }
+
+    resultado.nosExpandidos = static_cast<int>(expandidosPrimeira);
+    resultado.nosVisitados = static_cast<int>(visitadosPrimeira);
+    resultado.tempoMicros = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    resultado.metricas = busca.monitorBusca().finalizar(busca.maiorMemoria());
+    busca.registrarEstatisticas(resultado);
+    resultado.detalhes.push_back({"Expandidos na busca / na reconstrucao",
+                                  to_string(expandidosPrimeira) + " / " + to_string(busca.nosExpandidos() - expandidosPrimeira)});
+    return resultado;
+}
+
+// Planejador incremental (D* Lite) para um conjunto fixo de capacidades. A
+// busca é feita para trás, do objetivo até o estado inicial: g(s) é a
+// distância de s até o objetivo e rhs(s) = 1 + menor g entre os sucessores.
+// O objetivo entra como uma aresta de custo 0 até um nó objetivo virtual, de
+// modo que trocar o objetivo é só mudar o custo de duas arestas (a do antigo
+// e a do novo), e trocar o estado inicial só soma h(inicial antigo, novo) ao
+// deslocamento km das chaves. Os valores g/rhs e a lista aberta ficam de uma
+// chamada para a outra e a chamada seguinte repara só os estados afetados.
+//
+// A heurística entre dois estados é teto(jarros diferentes / 2): cada
+// movimento muda no máximo dois jarros, então ela é consistente e respeita a
+// desigualdade triangular que o km exige.
+//
+// Para trás, quase todo estado chega ao objetivo e cada um tem O(capacidade)
+// predecessores, enquanto para frente só uma pequena parte é alcançável: com
+// a heurística fraca, um reparo pode custar mais que planejar de novo. O
+// planejamento do zero só para quando o estado inicial fica consistente (a
+// árvore parcial fica para a próxima consulta) e não tem orçamento além do
+// limite de estados. Cada reparo tem um orçamento de estados gerados,
+// FATOR_ORCAMENTO vezes os gerados pelo último planejamento do zero; passando
+// dele, o planejador recomeça, a consulta é resolvida pela BFS e a próxima
+// chamada planeja do zero outra vez.
+class PlanejadorIncremental
+{
+public:
+    static constexpr int INFINITO = numeric_limits<int>::max() / 4;
+    static constexpr size_t LIMITE_ESTADOS = static_cast<size_t>(1) << 22; // acima disso recomeça do zero
+    static constexpr long long FATOR_ORCAMENTO = 2;
+
+    mutex trava; // uma chamada por vez em cada planejador
+
+    explicit PlanejadorIncremental(const vector<int> &capacidades)
+        : inst{static_cast<int>(capacidades.size()), capacidades, vector<int>(capacidades.size(), 0)},
+          codificador(inst), gerador(inst, false), atual(inst.n), auxiliar(inst.n)
+    {
+    }
+
+    bool suporta() const { return codificador.cabe(); }
+
+    ResultadoBusca planejar(const vector<Capacidade> &jarros)
+    {
+        auto start = high_resolution_clock::now();
+        MonitorBusca monitor("D* Lite (incremental)");
+        chamadas++;
+        string mudanca = "nenhuma";
+        if (estados.size() > LIMITE_ESTADOS)
+        {
+            reiniciar();
+            mudanca = "planejador reiniciado (limite de estados)";
+        }
+        reparoIncompleto = false;
+        size_t estadosAntes = estados.size();
+
+        vector<int> novoInicio = converterEstado(jarros);
+        Instancia consulta = criarInstancia(jarros);
+        vector<int> novoObjetivo = consulta.objetivo;
+        if (!objetivoCabe(consulta))
+            novoObjetivo.clear(); // nenhum estado é objetivo
+
+        if (inicio.empty())
+        {
+            inicio = novoInicio;
+            trocarObjetivo(novoObjetivo);
+            if (mudanca == "nenhuma")
+                mudanca = "primeira chamada";
+        }
+        else
+        {
+            bool mudouInicio = novoInicio != inicio, mudouObjetivo = novoObjetivo != objetivo;
+            if (mudouInicio)
+            {
+                km += distanciaMinima(inicio.data(), novoInicio.data());
+                inicio = novoInicio;
+            }
+            if (mudouObjetivo)
+                trocarObjetivo(novoObjetivo);
+            if (mudouInicio || mudouObjetivo)
+                mudanca = mudouInicio && mudouObjetivo ? "inicio e objetivo" : (mudouInicio ? "inicio" : "objetivo");
+        }
+
+        expandidos = reexpandidos = gerados = 0;
+        bool doZero = estadosAntes == 0;
+        long long orcamento = doZero ? numeric_limits<long long>::max() : max(FATOR_ORCAMENTO * geradosDoZero, 4096LL);
+        Parada parada = calcularCaminhos(monitor, estadosAntes, orcamento);
+        if (parada == PARADA_ORCAMENTO || parada == PARADA_ESTADOS)
+        {
+            reiniciar();
+            return resolverPorLargura(jarros, start, mudanca, parada == PARADA_ESTADOS ? "limite de " + to_string(LIMITE_ESTADOS) + " estados"
+                                                                               : "reparo mais caro que planejar do zero");
+        }
+        bool completa = parada == PARADA_CONCLUIDA;
+        if (doZero && completa)
+            geradosDoZero = gerados;
+
+        ResultadoBusca resultado;
+        resultado.metodo = "D* Lite (incremental)";
+        resultado.interrompida = !completa;
+        int s = localizar(inicio.data());
+        if (completa && s >= 0 && estados[s].g < INFINITO)
+        {
+            resultado.encontrou = true;
+            resultado.custo = estados[s].g;
+            resultado.caminho = extrairCaminho(estados[s].g);
+        }
+        resultado.nosExpandidos = static_cast<int>(expandidos);
+        resultado.nosVisitados = static_cast<int>(estados.size());
+        resultado.tempoMicros = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+        resultado.metricas = monitor.finalizar(indices.bytes() + niveisEstados.capacity() * sizeof(int) +
+                                               estados.capacity() * sizeof(EstadoPlanejado) + fila.capacity() * sizeof(EntradaFila));
+        resultado.detalhes.push_back({"Mudanca desde a chamada anterior", mudanca});
+        resultado.detalhes.push_back({"Chamada do planejador", to_string(chamadas)});
+        resultado.detalhes.push_back({"Estados reaproveitados", to_string(estadosAntes - reexpandidos)});
+        resultado.detalhes.push_back({"Estados reexpandidos", to_string(reexpandidos)});
+        resultado.detalhes.push_back({"Estados novos", to_string(estados.size() - estadosAntes)});
+        if (reparoIncompleto)
+            reiniciar(); // g/rhs ficaram pela metade; a próxima chamada começa do zero
+        return resultado;
+    }
+
+private:
+    // Por que calcularCaminhos parou
+    enum Parada
+    {
+        PARADA_CONCLUIDA,
+        PARADA_CONTROLE,  // prazo, limite de nós ou cancelamento
+        PARADA_ESTADOS,   // LIMITE_ESTADOS
+        PARADA_ORCAMENTO, // mais gerados que o orçamento da chamada
+    };
+
+    struct EstadoPlanejado
+    {
+        int g = INFINITO;
+        int rhs = INFINITO;
+        pair<int, int> chave;           // chave com que está na lista aberta
+        bool naFila = false;
+        long long ultimaExpansao = 0;   // chamada em que foi expandido pela última vez
+    };
+
+    // Entradas com chave diferente da guardada no estado são descartadas ao sair
+    struct EntradaFila
+    {
+        pair<int, int> chave;
+        int estado;
+
+        bool operator>(const EntradaFila &outra) const { return chave > outra.chave; }
+    };
+
+    Instancia inst;
+    CodificadorEstado codificador;
+    GeradorSucessores gerador;
+    TabelaChaves<int> indices;  // chave do estado -> posição em 'estados'
+    vector<int> niveisEstados;  // n níveis por estado, na mesma ordem
+    vector<EstadoPlanejado> estados;
+    vector<EntradaFila> fila;   // min-heap com remoção preguiçosa
+    vector<int> inicio, objetivo; // objetivo vazio = inválido
+    vector<int> atual, auxiliar, predecessores;
+    int km = 0;
+    long long chamadas = 0, expandidos = 0, reexpandidos = 0, gerados = 0;
+    long long geradosDoZero = 0;   // gerados pelo último planejamento do zero concluído
+    bool reparoIncompleto = false; // parou no meio de uma expansão (limite de estados ou prazo)
+
+    // Resolve a consulta com uma BFS nova, depois que o planejador desistiu dela
+    ResultadoBusca resolverPorLargura(const vector<Capacidade> &jarros, high_resolution_clock::time_point start,
+                                      const string &mudanca, const string &motivo)
+    {
+        ResultadoBusca resultado = buscaEmLargura(jarros);
+        resultado.metodo = "D* Lite (incremental, resolvido pela BFS)";
+        resultado.tempoMicros = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+        resultado.detalhes.push_back({"Mudanca desde a chamada anterior", mudanca});
+        resultado.detalhes.push_back({"Chamada do planejador", to_string(chamadas)});
+        resultado.detalhes.push_back({"Resolvido pela BFS", motivo});
+        return resultado;
+    }
+
+    void reiniciar()
+    {
+        indices = TabelaChaves<int>();
+        niveisEstados.clear();
+        estados.clear();
+        fila.clear();
+        inicio.clear();
+        objetivo.clear();
+        km = 0;
+    }
+
+    int distanciaMinima(const int *a, const int *b) const
+    {
+        int diferentes = 0;
+        for (int i = 0; i < inst.n; ++i)
+            diferentes += a[i] != b[i];
+        return (diferentes + 1) / 2;
+    }
+
+    const int *niveis(int s) const { return &niveisEstados[static_cast<size_t>(s) * inst.n]; }
+
+    int localizar(const int *niveisEstado) const
+    {
+        const int *indice = indices.buscar(codificador.codificar(niveisEstado));
+        return indice ? *indice : -1;
+    }
+
+    bool ehObjetivo(const int *niveisEstado) const
+    {
+        return !objetivo.empty() && equal(objetivo.begin(), objetivo.end(), niveisEstado);
+    }
+
+    pair<int, int> calcularChave(int s) const
+    {
+        int menor = min(estados[s].g, estados[s].rhs);
+        if (menor >= INFINITO)
+            return {INFINITO, INFINITO};
+        return {menor + distanciaMinima(inicio.data(), niveis(s)) + km, menor};
+    }
+
+    void inserirFila(int s, pair<int, int> chave)
+    {
+        estados[s].chave = chave;
+        estados[s].naFila = true;
+        fila.push_back({chave, s});
+        push_heap(fila.begin(), fila.end(), greater<EntradaFila>());
+    }
+
+    // Descarta as entradas obsoletas do topo; retorna se sobrou alguma válida
+    bool limparTopo()
+    {
+        while (!fila.empty())
+        {
+            const EntradaFila &topo = fila.front();
+            if (estados[topo.estado].naFila && estados[topo.estado].chave == topo.chave)
+                return true;
+            pop_heap(fila.begin(), fila.end(), greater<EntradaFila>());
+            fila.pop_back();
+        }
+        return false;
+    }
+
+    // Recoloca o estado na lista se ele ficou inconsistente (UpdateVertex)
+    void ajustarFila(int s)
+    {
+        estados[s].naFila = false;
+        if (estados[s].g != estados[s].rhs)
+            inserirFila(s, calcularChave(s));
+    }
+
+    // rhs pela definição: 0 no objetivo, senão 1 + menor g entre os sucessores
+    int rhsCompleto(const int *niveisEstado)
+    {
+        if (ehObjetivo(niveisEstado))
+            return 0;
+        int rhs = INFINITO;
+        gerador.gerar(niveisEstado, [&](const int *sucessor)
+                      {
+            int t = localizar(sucessor);
+            if (t >= 0 && estados[t].g < INFINITO)
+                rhs = min(rhs, estados[t].g + 1); });
+        return rhs;
+    }
+
+    // Posição do estado, criando-o com g = rhs = infinito se preciso. Só
+    // estados com algum caminho conhecido até o objetivo são guardados.
+    int obterOuCriar(const int *niveisEstado)
+    {
+        int s = localizar(niveisEstado);
+        if (s >= 0)
+            return s;
+        copy(niveisEstado, niveisEstado + inst.n, auxiliar.begin()); // pode apontar para niveisEstados
+        s = static_cast<int>(estados.size());
+        indices.inserir(codificador.codificar(auxiliar.data()), s);
+        niveisEstados.insert(niveisEstados.end(), auxiliar.begin(), auxiliar.end());
+        estados.emplace_back();
+        return s;
+    }
+
+    // Troca o objetivo: o antigo perde a aresta de custo 0 até o nó virtual e
+    // o novo a ganha; o resto do reparo fica para calcularCaminhos
+    void trocarObjetivo(const vector<int> &novo)
+    {
+        vector<int> antigo = objetivo;
+        objetivo = novo;
+        if (!antigo.empty())
+        {
+            int s = localizar(antigo.data());
+            if (s >= 0)
+            {
+                estados[s].rhs = rhsCompleto(antigo.data());
+                ajustarFila(s);
+            }
+        }
+        if (!objetivo.empty())
+        {
+            int s = obterOuCriar(objetivo.data());
+            estados[s].rhs = 0;
+            ajustarFila(s);
+        }
+    }
+
+    // ComputeShortestPath do D* Lite; para antes de concluir se o controle
+    // interromper, se os estados passarem de LIMITE_ESTADOS ou se os gerados
+    // passarem de 'orcamento'. Uma expansão pode criar O(capacidade)
+    // predecessores, então os limites e o prazo também são conferidos dentro
+    // dela.
+    Parada calcularCaminhos(MonitorBusca &monitor, size_t estadosAntes, long long orcamento)
+    {
+        const ControleBusca *controle = controleAtual;
+        long long iteracoes = 0, criados = 0;
+        while (limparTopo())
+        {
+            int s = localizar(inicio.data());
+            pair<int, int> chaveInicio = s < 0 ? make_pair(INFINITO, INFINITO) : calcularChave(s);
+            bool inicioInconsistente = s >= 0 && estados[s].g != estados[s].rhs;
+            if (!(fila.front().chave < chaveInicio) && !inicioInconsistente)
+                break;
+            if (deveInterromper(controle, ++iteracoes, expandidos))
+                return PARADA_CONTROLE;
+
+            EntradaFila topo = fila.front();
+            pop_heap(fila.begin(), fila.end(), greater<EntradaFila>());
+            fila.pop_back();
+            int u = topo.estado;
+            estados[u].naFila = false;
+            pair<int, int> chaveNova = calcularChave(u);
+            if (topo.chave < chaveNova)
+            {
+                inserirFila(u, chaveNova); // o km mudou desde que entrou na lista
+                continue;
+            }
+
+            expandidos++;
+            monitor.expandido(fila.size(), estados.size());
+            MedidorFase medidor(monitor, FASE_EXPANSAO);
+            if (static_cast<size_t>(u) < estadosAntes && estados[u].ultimaExpansao != chamadas)
+                reexpandidos++;
+            estados[u].ultimaExpansao = chamadas;
+
+            copy(niveis(u), niveis(u) + inst.n, atual.begin());
+            predecessores.clear();
+            gerarPredecessores(inst, atual.data(), predecessores);
+            gerados += static_cast<long long>(predecessores.size() / inst.n);
+            if (gerados > orcamento)
+            {
+                reparoIncompleto = true; // u já saiu da lista sem ser tratado
+                return PARADA_ORCAMENTO;
+            }
+            if (estados[u].g > estados[u].rhs)
+            {
+                // Sobreconsistente: g baixa para rhs e cada predecessor só
+                // precisa comparar o rhs atual com o caminho por u
+                int g = estados[u].g = estados[u].rhs;
+                for (size_t k = 0; k < predecessores.size(); k += inst.n)
+                {
+                    monitor.gerado();
+                    if (ehObjetivo(&predecessores[k]))
+                        continue;
+                    if (estados.size() >= LIMITE_ESTADOS)
+                    {
+                        reparoIncompleto = true;
+                        return PARADA_ESTADOS;
+                    }
+                    if (controle && (++criados & 1023) == 0 && controle->deveParar())
+                    {
+                        reparoIncompleto = true;
+                        return PARADA_CONTROLE;
+                    }
+                    int s = obterOuCriar(&predecessores[k]);
+                    if (g + 1 < estados[s].rhs)
+                    {
+                        estados[s].rhs = g + 1;
+                        ajustarFila(s);
+                    }
+                }
+            }
+            else
+            {
+                // Subconsistente: g vai a infinito e os predecessores cujo rhs
+                // vinha de u recalculam o rhs pelos outros sucessores
+                int gAntigo = estados[u].g;
+                estados[u].g = INFINITO;
+                ajustarFila(u);
+                for (size_t k = 0; k < predecessores.size(); k += inst.n)
+                {
+                    monitor.gerado();
+                    int s = localizar(&predecessores[k]);
+                    if (s < 0 || estados[s].rhs != gAntigo + 1 || ehObjetivo(&predecessores[k]))
+                        continue;
+                    estados[s].rhs = rhsCompleto(&predecessores[k]);
+                    ajustarFila(s);
+                }
+            }
+        }
+        return PARADA_CONCLUIDA;
+    }
+
+    // Desce do estado inicial pelos sucessores de menor g até o objetivo
+    vector<vector<int>> extrairCaminho(int custo)
+    {
+        vector<vector<int>> caminho = {inicio};
+        vector<int> passo = inicio, melhor(inst.n);
+        for (int restante = custo; restante > 0 && !ehObjetivo(passo.data()); --restante)
+        {
+            int menor = INFINITO;
+            gerador.gerar(passo.data(), [&](const int *sucessor)
+                          {
+                int t = localizar(sucessor);
+                if (t >= 0 && estados[t].g < menor)
+                {
+                    menor = estados[t].g;
+                    copy(sucessor, sucessor + inst.n, melhor.begin());
+                } });
+            if (menor >= INFINITO)
+                break;
+            passo = melhor;
+            caminho.push_back(passo);
+        }
+        return caminho;
+    }
+};
+
+// Planejadores incrementais já criados, um por conjunto de capacidades; acima
+// de LIMITE_PLANEJADORES o usado há mais tempo (LRU) dá lugar ao novo. Quem
+// ainda usa um planejador descartado o mantém vivo pelo shared_ptr.
+shared_ptr<PlanejadorIncremental> obterPlanejador(const vector<int> &capacidades)
+{
+    using Entrada = pair<vector<int>, shared_ptr<PlanejadorIncremental>>;
+    static const size_t LIMITE_PLANEJADORES = 16;
+    static mutex trava;
+    static list<Entrada> entradas; // do usado mais recentemente para o mais antigo
+    static map<vector<int>, list<Entrada>::iterator> indices;
+
+    lock_guard<mutex> guarda(trava);
+    auto it = indices.find(capacidades);
+    if (it != indices.end())
+    {
+        entradas.splice(entradas.begin(), entradas, it->second); // mais recente
+        return it->second->second;
+    }
+    if (entradas.size() >= LIMITE_PLANEJADORES)
+    {
+        indices.erase(entradas.back().first);
+        entradas.pop_back();
+    }
+    entradas.emplace_front(capacidades, make_shared<PlanejadorIncremental>(capacidades));
+    indices[capacidades] = entradas.begin();
+    return entradas.front().second;
+}
+
+// Replanejamento incremental: consultas seguidas sobre os mesmos jarros (só o
+// nível inicial ou o objetivo mudam) reaproveitam a busca da consulta anterior
+ResultadoBusca buscaIncremental(const vector<Capacidade> &jarros)
+{
+    Instancia inst = criarInstancia(jarros);
+    shared_ptr<PlanejadorIncremental> planejador = obterPlanejador(inst.capacidadeMax);
+    if (!planejador->suporta())
+    {
+        ResultadoBusca resultado = buscaAEstrela(jarros);
+        resultado.metodo = "A* (estado grande demais para o planejador incremental)";
+        return resultado;
+    }
+    lock_guard<mutex> guarda(planejador->trava);
+    return planejador->planejar(jarros);
+}
+
+// Cabeçalho do arquivo de uma base de soluções pré-computada (ver
+// BaseSolucoes). Depois dele vêm as capacidades e os objetivos (int32 cada),
+// as distâncias (uint16 por estado) e os próximos movimentos (uint8 por
+// estado), na ordem de bytes da máquina que gravou o arquivo.
+struct CabecalhoBaseSolucoes
+{
+    static constexpr uint32_t VERSAO = 1;
+    static constexpr uint32_t ORDEM_BYTES = 0x01020304;
+
+    char magica[8] = {'J', 'A', 'R', 'R', 'O', 'B', 'S', 0};
+    uint32_t versao = VERSAO;
+    uint32_t ordemBytes = ORDEM_BYTES; // lido diferente se a ordem de bytes mudar
+    uint32_t jarros = 0;
+    uint32_t movimentos = 0; // quantidade de listarMovimentos(jarros)
+    uint64_t estados = 0;
+
+    // Deslocamento das distâncias: o cabeçalho tem 32 bytes e as duas listas
+    // de int32 somam 8 bytes por jarro, então as distâncias ficam alinhadas
+    size_t inicioDistancias() const { return sizeof(CabecalhoBaseSolucoes) + 2 * sizeof(int32_t) * jarros; }
+    size_t tamanhoArquivo() const { return inicioDistancias() + estados * (sizeof(uint16_t) + sizeof(uint8_t)); }
+};
+static_assert(sizeof(CabecalhoBaseSolucoes) == 32, "cabecalho da base de solucoes deve ter 32 bytes");
+
+// Tabela retrógrada: uma BFS reversa a partir do objetivo sobre todo o espaço
+// de estados guarda, para cada estado (indexado em base mista pelos níveis),
+// a distância até o objetivo e o índice do primeiro movimento de um caminho
+// ótimo. Depois de construída, cada consulta apenas segue os movimentos.
+class TabelaRetrograda
+{
+public:
+    static constexpr uint16_t INALCANCAVEL = numeric_limits<uint16_t>::max();
+
+    // Quantidade de estados do espaço completo (0 se passar de 'limite')
+    static size_t numeroEstados(const Instancia &inst, size_t limite)
+    {
+        size_t total = 1;
+        for (int capacidade : inst.capacidadeMax)
+        {
+            size_t valores = static_cast<size_t>(capacidade) + 1;
+            if (total > limite / valores)
+                return 0;
+            total *= valores;
+        }
+        return total;
+    }
+
+    static size_t bytesPorEstado() { return sizeof(uint16_t) + sizeof(uint8_t); }
+
+    // Constrói a tabela; 'completa()' fica falso se o espaço não puder ser
+    // representado (movimentos ou distâncias grandes demais)
+    explicit TabelaRetrograda(const Instancia &inst) : inst(inst), movimentos(listarMovimentos(inst.n))
+    {
+        auto inicio = high_resolution_clock::now();
+        size_t total = numeroEstados(inst, numeric_limits<uint32_t>::max());
+        if (total == 0 || movimentos.size() > numeric_limits<uint8_t>::max())
+            return;
+        for (int i = 0; i < inst.n; ++i)
+            pesos.push_back(i == 0 ? 1 : pesos[i - 1] * (static_cast<size_t>(inst.capacidadeMax[i - 1]) + 1));
+        distancias.assign(total, INALCANCAVEL);
+        proximoMovimento.assign(total, 0);
+        completa = true;
+        if (objetivoCabe(inst))
+            construir();
+        tempoConstrucaoMicros = duration_cast<microseconds>(high_resolution_clock::now() - inicio).count();
+    }
+
+    bool valida() const { return completa; }
+
+    size_t indice(const int *niveis) const
+    {
+        size_t indice = 0;
+        for (int i = 0; i < inst.n; ++i)
+            indice += static_cast<size_t>(niveis[i]) * pesos[i];
+        return indice;
+    }
+
+    uint16_t distancia(const int *niveis) const { return distancias[indice(niveis)]; }
+    const Movimento &melhorMovimento(const int *niveis) const { return movimentos[proximoMovimento[indice(niveis)]]; }
+
+    size_t bytes() const { return distancias.size() * bytesPorEstado(); }
+    long long tempoConstrucao() const { return tempoConstrucaoMicros; }
+
+    // Quantidade de estados com caminho até o objetivo
+    size_t alcancaveis() const
+    {
+        return static_cast<size_t>(count_if(distancias.begin(), distancias.end(), [](uint16_t d)
+                                            { return d != INALCANCAVEL; }));
+    }
+
+    // Grava a tabela no formato de BaseSolucoes. Escreve num arquivo
+    // temporário e renomeia no fim, para que um processo que mapeie o arquivo
+    // nunca veja uma base pela metade.
+    bool gravar(const string &arquivo, string &erro) const
+    {
+        CabecalhoBaseSolucoes cabecalho;
+        cabecalho.jarros = static_cast<uint32_t>(inst.n);
+        cabecalho.movimentos = static_cast<uint32_t>(movimentos.size());
+        cabecalho.estados = distancias.size();
+        vector<int32_t> configuracaoJarros(inst.capacidadeMax.begin(), inst.capacidadeMax.end());
+        configuracaoJarros.insert(configuracaoJarros.end(), inst.objetivo.begin(), inst.objetivo.end());
+
+        string temporario = arquivo + ".tmp";
+        {
+            ofstream saida(temporario, ios::binary | ios::trunc);
+            saida.write(reinterpret_cast<const char *>(&cabecalho), sizeof(cabecalho));
+            saida.write(reinterpret_cast<const char *>(configuracaoJarros.data()), configuracaoJarros.size() * sizeof(int32_t));
+            saida.write(reinterpret_cast<const char *>(distancias.data()), distancias.size() * sizeof(uint16_t));
+            saida.write(reinterpret_cast<const char *>(proximoMovimento.data()), proximoMovimento.size());
+            if (!saida)
+            {
+                erro = "falha ao escrever " + temporario;
+                return false;
+            }
+        }
+        error_code codigo;
+        filesystem::rename(temporario, arquivo, codigo);
+        if (codigo)
+        {
+            erro = "falha ao renomear para " + arquivo + ": " + codigo.message();
+            return false;
+        }
+        return true;
+    }
+
+private:
+    Instancia inst;
+    vector<Movimento> movimentos;
+    vector<size_t> pesos;
+    vector<uint16_t> distancias;
+    vector<uint8_t> proximoMovimento;
+    bool completa = false;
+    long long tempoConstrucaoMicros = 0;
+
+    void construir()
+    {
+        int n = inst.n;
+        vector<uint32_t> fila;
+        fila.push_back(static_cast<uint32_t>(indice(inst.objetivo.data())));
+        distancias[fila.back()] = 0;
+
+        vector<int> niveis(n), predecessores, depois(n);
+        for (size_t frente = 0; frente < fila.size(); ++frente)
+        {
+            size_t atual = fila[frente];
+            if (distancias[atual] + 1 == INALCANCAVEL)
+            {
+                completa = false; // distâncias não cabem em 16 bits
+                return;
+            }
+            uint16_t proxima = static_cast<uint16_t>(distancias[atual] + 1);
+            size_t resto = atual;
+            for (int i = n - 1; i >= 0; --i)
+            {
+                niveis[i] = static_cast<int>(resto / pesos[i]);
+                resto %= pesos[i];
+            }
+
+            predecessores.clear();
+            gerarPredecessores(inst, niveis.data(), predecessores);
+            for (size_t p = 0; p < predecessores.size(); p += n)
+            {
+                const int *anterior = &predecessores[p];
+                size_t indiceAnterior = indice(anterior);
+                if (distancias[indiceAnterior] != INALCANCAVEL)
+                    continue;
+
+                // Descobre qual movimento leva do predecessor ao estado atual
+                for (size_t m = 0; m < movimentos.size(); ++m)
+                {
+                    copy(anterior, anterior + n, depois.begin());
+                    aplicarMovimento(inst, depois.data(), movimentos[m]);
+                    if (equal(depois.begin(), depois.end(), niveis.begin()))
+                    {
+                        proximoMovimento[indiceAnterior] = static_cast<uint8_t>(m);
+                        break;
+                    }
+                }
+                distancias[indiceAnterior] = proxima;
+                fila.push_back(static_cast<uint32_t>(indiceAnterior));
+            }
+        }
+    }
+};
+
+// Cache de tabelas retrógradas por par (capacidades, objetivos), com descarte
+// do item usado há mais tempo (LRU) quando a soma das tabelas passa do orçamento
+class CacheRetrogrado
+{
+public:
+    // Retorna a tabela do par, construindo-a se preciso; nulo se ela não
+    // couber no orçamento. 'acerto' indica se a tabela já estava no cache.
+    shared_ptr<const TabelaRetrograda> obter(const Instancia &inst, bool &acerto)
+    {
+        pair<vector<int>, vector<int>> chave = {inst.capacidadeMax, inst.objetivo};
+        size_t orcamento = configuracao.orcamentoCacheRetrogrado;
+        {
+            lock_guard<mutex> guarda(trava);
+            auto it = indices.find(chave);
+            if (it != indices.end())
+            {
+                acerto = true;
+                acertos++;
+                entradas.splice(entradas.begin(), entradas, it->second); // mais recente
+                return it->second->second;
+            }
+            acerto = false;
+            falhas++;
+        }
+
+        size_t estados = TabelaRetrograda::numeroEstados(inst, orcamento / TabelaRetrograda::bytesPorEstado());
+        if (estados == 0)
+            return nullptr;
+
+        // Constrói fora da trava para não bloquear consultas a outras tabelas
+        auto tabela = make_shared<const TabelaRetrograda>(inst);
+        if (!tabela->valida())
+            return nullptr;
+
+        lock_guard<mutex> guarda(trava);
+        auto it = indices.find(chave);
+        if (it != indices.end())
+            return it->second->second; // outra thread construiu a mesma tabela
+        entradas.emplace_front(chave, tabela);
+        indices[chave] = entradas.begin();
+        bytesUsados += tabela->bytes();
+        while (bytesUsados > orcamento && entradas.size() > 1)
+        {
+            bytesUsados -= entradas.back().second->bytes();
+            indices.erase(entradas.back().first);
+            entradas.pop_back();
+            descartes++;
+        }
+        return tabela;
+    }
+
+    // Resumo "acertos/falhas/descartes/tabelas/bytes" para as estatísticas
+    string resumo()
+    {
+        lock_guard<mutex> guarda(trava);
+        return to_string(acertos) + " acertos, " + to_string(falhas) + " falhas, " + to_string(descartes) +
+               " descartes, " + to_string(entradas.size()) + " tabelas, " + to_string(bytesUsados) + " bytes";
+    }
+
+private:
+    using Chave = pair<vector<int>, vector<int>>;
+    using Entrada = pair<Chave, shared_ptr<const TabelaRetrograda>>;
+
+    mutex trava;
+    list<Entrada> entradas; // da usada mais recentemente para a mais antiga
+    map<Chave, list<Entrada>::iterator> indices;
+    size_t bytesUsados = 0;
+    long long acertos = 0, falhas = 0, descartes = 0;
+};
+
+CacheRetrogrado cacheRetrogrado;
+
+// Base de soluções pré-computada: uma tabela retrógrada gravada em disco por
+// 'jarro --gerar-base' e mapeada só para leitura (mmap, ou MapViewOfFile no
+// Windows). As consultas leem direto das páginas do arquivo, sem cópia nem
+// construção, e processos que mapeiam a mesma base dividem o cache de páginas
+// do sistema. O índice do estado é o mesmo da tabela retrógrada (base mista
+// pelos níveis).
+class BaseSolucoes
+{
+public:
+    BaseSolucoes() = default;
+    BaseSolucoes(const BaseSolucoes &) = delete;
+    BaseSolucoes &operator=(const BaseSolucoes &) = delete;
+
+    ~BaseSolucoes()
+    {
+        if (!dados)
+            return;
+#ifdef _WIN32
+        UnmapViewOfFile(dados);
+#else
+        munmap(const_cast<uint8_t *>(dados), tamanho);
+#endif
+    }
+
+    // Mapeia e valida o arquivo; em erro preenche 'erro' e retorna falso
+    bool abrir(const string &caminho, string &erro)
+    {
+        arquivo = caminho;
+        if (!mapear(erro))
+            return false;
+
+        CabecalhoBaseSolucoes cabecalho;
+        if (tamanho < sizeof(cabecalho))
+        {
+            erro = "arquivo menor que o cabecalho";
+            return false;
+        }
+        memcpy(&cabecalho, dados, sizeof(cabecalho));
+        if (memcmp(cabecalho.magica, CabecalhoBaseSolucoes().magica, sizeof(cabecalho.magica)) != 0)
+        {
+            erro = "nao e uma base de solucoes";
+            return false;
+        }
+        if (cabecalho.ordemBytes != CabecalhoBaseSolucoes::ORDEM_BYTES)
+        {
+            erro = "base gravada em outra ordem de bytes";
+            return false;
+        }
+        if (cabecalho.versao != CabecalhoBaseSolucoes::VERSAO)
+        {
+            erro = "versao " + to_string(cabecalho.versao) + " nao suportada (esperada " + to_string(CabecalhoBaseSolucoes::VERSAO) + ")";
+            return false;
+        }
+        if (cabecalho.jarros == 0 || cabecalho.jarros > 64 || tamanho < cabecalho.inicioDistancias())
+        {
+            erro = "quantidade de jarros invalida";
+            return false;
+        }
+
+        int n = static_cast<int>(cabecalho.jarros);
+        const int32_t *configuracaoJarros = reinterpret_cast<const int32_t *>(dados + sizeof(cabecalho));
+        capacidades.assign(configuracaoJarros, configuracaoJarros + n);
+        objetivos.assign(configuracaoJarros + n, configuracaoJarros + 2 * n);
+        movimentos = listarMovimentos(n);
+
+        size_t esperados = 1;
+        for (int i = 0; i < n; ++i)
+        {
+            if (capacidades[i] < 0 || objetivos[i] < 0 || objetivos[i] > capacidades[i])
+            {
+                erro = "capacidades ou objetivos invalidos";
+                return false;
+            }
+            pesos.push_back(esperados);
+            esperados *= static_cast<size_t>(capacidades[i]) + 1;
+        }
+        if (cabecalho.movimentos != movimentos.size() || cabecalho.estados != esperados ||
+            cabecalho.tamanhoArquivo() != tamanho)
+        {
+            erro = "tamanho do arquivo nao confere com o cabecalho";
+            return false;
+        }
+        distancias = reinterpret_cast<const uint16_t *>(dados + cabecalho.inicioDistancias());
+        proximoMovimento = reinterpret_cast<const uint8_t *>(distancias + cabecalho.estados);
+        return true;
+    }
+
+    bool atende(const Instancia &inst) const { return inst.capacidadeMax == capacidades && inst.objetivo == objetivos; }
+
+    size_t indice(const int *niveis) const
+    {
+        size_t indice = 0;
+        for (size_t i = 0; i < pesos.size(); ++i)
+            indice += static_cast<size_t>(niveis[i]) * pesos[i];
+        return indice;
+    }
+
+    uint16_t distancia(const int *niveis) const { return distancias[indice(niveis)]; }
+
+    // Movimento guardado para o estado; nulo se o byte lido for inválido
+    const Movimento *melhorMovimento(const int *niveis) const
+    {
+        uint8_t m = proximoMovimento[indice(niveis)];
+        return m < movimentos.size() ? &movimentos[m] : nullptr;
+    }
+
+    const string &nome() const { return arquivo; }
+    size_t bytes() const { return tamanho; }
+
+private:
+    string arquivo;
+    const uint8_t *dados = nullptr;
+    size_t tamanho = 0;
+    vector<int> capacidades, objetivos;
+    vector<size_t> pesos;
+    vector<Movimento> movimentos;
+    const uint16_t *distancias = nullptr;
+    const uint8_t *proximoMovimento = nullptr;
+
+    bool mapear(string &erro)
+    {
+#ifdef _WIN32
+        HANDLE manipulador = CreateFileA(arquivo.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                         FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (manipulador == INVALID_HANDLE_VALUE)
+        {
+            erro = "nao foi possivel abrir " + arquivo;
+            return false;
+        }
+        LARGE_INTEGER tamanhoArquivo;
+        HANDLE mapa = nullptr;
+        if (GetFileSizeEx(manipulador, &tamanhoArquivo) && tamanhoArquivo.QuadPart > 0)
+            mapa = CreateFileMappingA(manipulador, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapa)
+        {
+            dados = static_cast<const uint8_t *>(MapViewOfFile(mapa, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(mapa);
+        }
+        CloseHandle(manipulador);
+        if (!dados)
+        {
+            erro = "nao foi possivel mapear " + arquivo;
+            return false;
+        }
+        tamanho = static_cast<size_t>(tamanhoArquivo.QuadPart);
+#else
+        int descritor = open(arquivo.c_str(), O_RDONLY);
+        if (descritor < 0)
+        {
+            erro = "nao foi possivel abrir " + arquivo + ": " + strerror(errno);
+            return false;
+        }
+        struct stat informacoes;
+        if (fstat(descritor, &informacoes) != 0 || informacoes.st_size <= 0)
+        {
+            close(descritor);
+            erro = "arquivo vazio ou ilegivel: " + arquivo;
+            return false;
+        }
+        tamanho = static_cast<size_t>(informacoes.st_size);
+        void *mapa = mmap(nullptr, tamanho, PROT_READ, MAP_SHARED, descritor, 0);
+        close(descritor); // o mapeamento continua válido sem o descritor
+        if (mapa == MAP_FAILED)
+        {
+            tamanho = 0;
+            erro = "nao foi possivel mapear " + arquivo + ": " + strerror(errno);
+            return false;
+        }
+        dados = static_cast<const uint8_t *>(mapa);
+#endif
+        return true;
+    }
+};
+
+// Bases carregadas na inicialização (--base); só leitura depois disso, então
+// as threads do serviço e do lote consultam sem trava
+vector<unique_ptr<BaseSolucoes>> basesSolucoes;
+
+const BaseSolucoes *procurarBase(const Instancia &inst)
+{
+    for (const auto &base : basesSolucoes)
+        if (base->atende(inst))
+            return base.get();
+    return nullptr;
+}
+
+// Gera uma base de soluções para as capacidades e os objetivos dados: resolve
+// o espaço inteiro com a tabela retrógrada e grava o arquivo
+int gerarBaseSolucoes(const string &arquivo, const vector<int> &capacidades, const vector<int> &objetivos)
+{
+    vector<Capacidade> jarros(capacidades.size());
+    for (size_t i = 0; i < capacidades.size(); ++i)
+    {
+        jarros[i].capacidadeMax = capacidades[i];
+        jarros[i].objetivo = objetivos[i];
+        if (capacidades[i] < 0 || objetivos[i] < 0 || objetivos[i] > capacidades[i])
+        {
+            cerr << "Objetivo do jarro " << i + 1 << " fora de 0.." << capacidades[i] << endl;
+            return 1;
+        }
+    }
+    Instancia inst = criarInstancia(jarros);
+    TabelaRetrograda tabela(inst);
+    if (!tabela.valida())
+    {
+        cerr << "Espaco de estados grande demais para uma base de solucoes" << endl;
+        return 1;
+    }
+    string erro;
+    if (!tabela.gravar(arquivo, erro))
+    {
+        cerr << erro << endl;
+        return 1;
+    }
+    cout << "Base gravada em " << arquivo << ": " << tabela.bytes() / TabelaRetrograda::bytesPorEstado() << " estados ("
+         << tabela.alcancaveis() << " com solucao), " << tabela.bytes() << " bytes de tabela, construida em "
+         << tabela.tempoConstrucao() << " us" << endl;
+    return 0;
+}
+
+// Responde à consulta seguindo a tabela retrógrada do par (capacidades,
+// objetivos) em O(tamanho da solução). Se a tabela não couber no orçamento
+// do cache, recorre à Busca em Largura.
+ResultadoBusca buscaTabelaRetrograda(const vector<Capacidade> &jarros)
+{
+    auto inicio = high_resolution_clock::now();
+    Instancia inst = criarInstancia(jarros);
+    if (const BaseSolucoes *base = procurarBase(inst))
+    {
+        ArenaNos arena(inst.n);
+        vector<int> niveis = converterEstado(jarros);
+        int atual = arena.criar(niveis.data(), -1, 0, 0);
+        int noObjetivo = -1;
+        uint16_t distancia = base->distancia(niveis.data());
+        bool integra = true;
+        if (distancia != TabelaRetrograda::INALCANCAVEL)
+        {
+            // Cada passo precisa reduzir a distância em 1; do contrário o
+            // arquivo está corrompido e a consulta cai na tabela em memória
+            while (distancia > 0 && integra)
+            {
+                const Movimento *mov = base->melhorMovimento(niveis.data());
+                if (mov)
+                    aplicarMovimento(inst, niveis.data(), *mov);
+                integra = mov && base->distancia(niveis.data()) == distancia - 1;
+                distancia = base->distancia(niveis.data());
+                atual = arena.criar(niveis.data(), atual, arena.no(atual).g + 1, 0);
+            }
+            noObjetivo = atual;
+        }
+        if (integra)
+        {
+            ResultadoBusca resultado = montarResultado("Tabela Retrograda", arena, noObjetivo, arena.size(), arena.size() - 1, inicio);
+            resultado.detalhes.push_back({"Tabela", "base pre-computada " + base->nome() + " (mapeada)"});
+            resultado.detalhes.push_back({"Tamanho da base", to_string(base->bytes()) + " bytes"});
+            return resultado;
+        }
+    }
+
+    bool acerto = false;
+    shared_ptr<const TabelaRetrograda> tabela = cacheRetrogrado.obter(inst, acerto);
+    if (!tabela)
+    {
+        ResultadoBusca resultado = buscaEmLargura(jarros);
+        resultado.detalhes.push_back({"Tabela retrograda", "nao cabe no orcamento, usada a BFS"});
+        resultado.detalhes.push_back({"Cache retrogrado", cacheRetrogrado.resumo()});
+        return resultado;
+    }
+
+    ArenaNos arena(inst.n);
+    vector<int> niveis = converterEstado(jarros);
+    int atual = arena.criar(niveis.data(), -1, 0, 0);
+    int noObjetivo = -1;
+    if (tabela->distancia(niveis.data()) != TabelaRetrograda::INALCANCAVEL)
+    {
+        while (tabela->distancia(niveis.data()) > 0)
+        {
+            aplicarMovimento(inst, niveis.data(), tabela->melhorMovimento(niveis.data()));
+            atual = arena.criar(niveis.data(), atual, arena.no(atual).g + 1, 0);
+        }
+        noObjetivo = atual;
+    }
+
+    ResultadoBusca resultado = montarResultado("Tabela Retrograda", arena, noObjetivo, arena.size(), arena.size() - 1, inicio);
+    resultado.detalhes.push_back({"Tabela", acerto ? "reutilizada do cache"
+                                                   : "construida nesta consulta (" + to_string(tabela->tempoConstrucao()) + " us)"});
+    resultado.detalhes.push_back({"Tamanho da tabela", to_string(tabela->bytes()) + " bytes"});
+    resultado.detalhes.push_back({"Cache retrogrado", cacheRetrogrado.resumo()});
+    return resultado;
+}
+
+// Mapa de 2 bits por estado do espaço completo, com o estado indexado em base
+// mista pelos níveis (como na tabela retrógrada). Cada palavra de 64 bits
+// guarda 32 estados; as marcações usam compare_exchange na palavra, então
+// várias threads podem marcar ao mesmo tempo.
+class MapaDoisBits
+{
+public:
+    static constexpr uint64_t NAO_VISTO = 0, ATUAL = 1, PROXIMO = 2, CONCLUIDO = 3;
+    static constexpr uint64_t BITS_BAIXOS = 0x5555555555555555ULL;
+    static constexpr size_t ESTADOS_POR_PALAVRA = 32;
+
+    explicit MapaDoisBits(size_t estados)
+        : estados(estados), quantidadePalavras((estados + ESTADOS_POR_PALAVRA - 1) / ESTADOS_POR_PALAVRA),
+          palavras(new atomic<uint64_t>[quantidadePalavras]()) {}
+
+    size_t numeroPalavras() const { return quantidadePalavras; }
+    size_t bytes() const { return quantidadePalavras * sizeof(uint64_t); }
+    uint64_t palavra(size_t p) const { return palavras[p].load(memory_order_relaxed); }
+    void definirPalavra(size_t p, uint64_t valor) { palavras[p].store(valor, memory_order_relaxed); }
+
+    uint64_t valor(size_t estado) const { return (palavra(estado / ESTADOS_POR_PALAVRA) >> (2 * (estado % ESTADOS_POR_PALAVRA))) & 3; }
+
+    // Marca o estado como PROXIMO se ainda não foi visto; retorna se marcou
+    bool marcarProximo(size_t estado)
+    {
+        atomic<uint64_t> &alvo = palavras[estado / ESTADOS_POR_PALAVRA];
+        int deslocamento = static_cast<int>(2 * (estado % ESTADOS_POR_PALAVRA));
+        uint64_t atual = alvo.load(memory_order_relaxed);
+        while (((atual >> deslocamento) & 3) == NAO_VISTO)
+        {
+            if (alvo.compare_exchange_weak(atual, atual | (PROXIMO << deslocamento), memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    // Bits baixos dos pares que estão em ATUAL (01) na palavra
+    static uint64_t atuais(uint64_t palavra) { return palavra & ~(palavra >> 1) & BITS_BAIXOS; }
+
+    // Fim de nível: ATUAL -> CONCLUIDO e PROXIMO -> ATUAL, direto na palavra.
+    // Com b = bits baixos e a = bits altos de cada par, o novo par é
+    // (b | a) no bit baixo e b no bit alto.
+    static uint64_t avancarNivel(uint64_t palavra)
+    {
+        uint64_t baixos = palavra & BITS_BAIXOS, altos = (palavra >> 1) & BITS_BAIXOS;
+        return baixos | altos | (baixos << 1);
+    }
+
+    // Pares NAO_VISTO viram CONCLUIDO e os demais viram NAO_VISTO
+    static uint64_t complemento(uint64_t palavra)
+    {
+        uint64_t vistos = (palavra | (palavra >> 1)) & BITS_BAIXOS, naoVistos = ~vistos & BITS_BAIXOS;
+        return naoVistos | (naoVistos << 1);
+    }
+
+    // Quantidade de pares em PROXIMO na palavra
+    static int proximos(uint64_t palavra)
+    {
+        uint64_t baixos = palavra & BITS_BAIXOS, altos = (palavra >> 1) & BITS_BAIXOS;
+        return __builtin_popcountll(altos & ~baixos);
+    }
+
+private:
+    size_t estados, quantidadePalavras;
+    unique_ptr<atomic<uint64_t>[]> palavras;
+};
+
+// Busca em Largura densa: percorre o espaço nível a nível varrendo o mapa de
+// 2 bits (não visto / atual / próximo / concluído). Os blocos de palavras são
+// repartidos entre as threads do pool; a troca de nível é uma operação por
+// palavra. Como o mapa não guarda pais nem distâncias, o caminho é refeito por
+// divisão e conquista: uma varredura para frente a partir da origem e outra
+// para trás (predecessores) a partir do destino, cada uma até a metade da
+// distância, se encontram em um estado intermediário de um caminho ótimo, e
+// cada metade é resolvida do mesmo jeito. A varredura para trás fica restrita
+// aos estados alcançáveis da enumeração; sem isso os predecessores levariam a
+// boa parte do espaço completo.
+class LarguraDensa
+{
+public:
+    LarguraDensa(const Instancia &inst, size_t estados, PoolThreads &pool)
+        : inst(inst), estados(estados), pool(pool), alcance(estados), frente(estados), tras(estados)
+    {
+        for (int i = 0; i < inst.n; ++i)
+            pesos.push_back(i == 0 ? 1 : pesos[i - 1] * (static_cast<size_t>(inst.capacidadeMax[i - 1]) + 1));
+    }
+
+    size_t indice(const int *niveis) const
+    {
+        size_t indice = 0;
+        for (int i = 0; i < inst.n; ++i)
+            indice += static_cast<size_t>(niveis[i]) * pesos[i];
+        return indice;
+    }
+
+    void decodificar(size_t indice, int *niveis) const
+    {
+        for (int i = inst.n - 1; i >= 0; --i)
+        {
+            niveis[i] = static_cast<int>(indice / pesos[i]);
+            indice %= pesos[i];
+        }
+    }
+
+    // Enumera tudo o que é alcançável a partir de 'origem'. Retorna false se
+    // foi interrompida; 'profundidadeAlvo' fica -1 se 'alvo' não foi alcançado.
+    bool enumerar(size_t origem, size_t alvo, int &profundidadeAlvo)
+    {
+        profundidadeAlvo = -1;
+        return varrer(alcance, origem, false, numeric_limits<int>::max(), alvo, profundidadeAlvo, true);
+    }
+
+    // Estados de um caminho ótimo de 'origem' até 'destino', que estão a 'distancia' passos
+    bool reconstruir(size_t origem, size_t destino, int distancia, vector<size_t> &caminho)
+    {
+        caminho = {origem};
+        return reconstruirTrecho(origem, destino, distancia, caminho);
+    }
+
+    const vector<size_t> &tamanhosNiveis() const { return niveis; }
+    long long expandidos() const { return totalExpandidos.load(); }
+    long long gerados() const { return totalGerados.load(); }
+    long long varreduras() const { return totalVarreduras; }
+    size_t bytes() const { return alcance.bytes() + frente.bytes() + tras.bytes(); }
+
+    // Mapas usados: a enumeração e as duas varreduras da reconstrução
+    static constexpr size_t MAPAS = 3;
+
+private:
+    const Instancia &inst;
+    size_t estados;
+    PoolThreads &pool;
+    MapaDoisBits alcance, frente, tras; // 'alcance' guarda o resultado da enumeração
+    vector<size_t> pesos;
+    vector<size_t> niveis; // estados em cada nível da enumeração
+    atomic<long long> totalExpandidos{0}, totalGerados{0};
+    long long totalVarreduras = 0;
+
+    // BFS de 2 bits em 'mapa' a partir de 'origem' (predecessores com
+    // 'reversa') por até 'limite' níveis ou até a fronteira esvaziar. Se 'alvo'
+    // aparecer, guarda o nível em 'profundidadeAlvo' e para ali, a não ser com
+    // 'enumerarTudo', que também registra o tamanho de cada nível. No fim, os
+    // estados em ATUAL são a última fronteira. 'permitidos' restringe a
+    // varredura aos estados vistos naquele mapa.
+    bool varrer(MapaDoisBits &mapa, size_t origem, bool reversa, int limite, size_t alvo, int &profundidadeAlvo, bool enumerarTudo,
+                const MapaDoisBits *permitidos = nullptr)
+    {
+        const size_t bloco = 256;
+        const ControleBusca *controle = controleAtual;
+        atomic<size_t> cursor(0);
+        atomic<bool> interrompida(false);
+        int threads = pool.tamanho();
+        vector<size_t> novos(threads);
+
+        // Com 'permitidos', os estados fora dele já começam concluídos e nunca são marcados
+        pool.executar([&](int id)
+                      {
+            for (size_t p = id; p < mapa.numeroPalavras(); p += threads)
+                mapa.definirPalavra(p, permitidos ? MapaDoisBits::complemento(permitidos->palavra(p)) : 0); });
+        size_t palavraOrigem = origem / MapaDoisBits::ESTADOS_POR_PALAVRA;
+        int deslocamento = static_cast<int>(2 * (origem % MapaDoisBits::ESTADOS_POR_PALAVRA));
+        mapa.definirPalavra(palavraOrigem, (mapa.palavra(palavraOrigem) & ~(3ULL << deslocamento)) | (MapaDoisBits::ATUAL << deslocamento));
+        if (enumerarTudo)
+            niveis = {1};
+        if (origem == alvo)
+        {
+            profundidadeAlvo = 0;
+            if (!enumerarTudo)
+                return true;
+        }
+
+        for (int nivel = 0; nivel < limite; ++nivel)
+        {
+            // Expansão: sucessores (ou predecessores) de cada estado em ATUAL viram PROXIMO
+            cursor = 0;
+            pool.executar([&](int)
+                          {
+                GeradorSucessores gerador(inst, false);
+                vector<int> atual(inst.n), predecessores;
+                long long expandidosLocal = 0, geradosLocal = 0;
+                auto visitar = [&](const int *vizinho)
+                {
+                    geradosLocal++;
+                    mapa.marcarProximo(indice(vizinho));
+                };
+                while (!interrompida.load(memory_order_relaxed))
+                {
+                    if (controle && controle->deveParar())
+                    {
+                        interrompida = true;
+                        break;
+                    }
+                    size_t inicio = cursor.fetch_add(bloco);
+                    if (inicio >= mapa.numeroPalavras())
+                        break;
+                    size_t fim = min(inicio + bloco, mapa.numeroPalavras());
+                    for (size_t p = inicio; p < fim; ++p)
+                    {
+                        for (uint64_t pares = MapaDoisBits::atuais(mapa.palavra(p)); pares != 0; pares &= pares - 1)
+                        {
+                            size_t estado = p * MapaDoisBits::ESTADOS_POR_PALAVRA + __builtin_ctzll(pares) / 2;
+                            decodificar(estado, atual.data());
+                            expandidosLocal++;
+                            if (!reversa)
+                            {
+                                gerador.gerar(atual.data(), visitar);
+                                continue;
+                            }
+                            predecessores.clear();
+                            gerarPredecessores(inst, atual.data(), predecessores);
+                            for (size_t k = 0; k < predecessores.size(); k += inst.n)
+                                visitar(&predecessores[k]);
+                        }
+                    }
+                }
+                totalExpandidos += expandidosLocal;
+                totalGerados += geradosLocal; });
+            if (interrompida.load())
+                return false;
+            bool alvoNoProximo = alvo < estados && mapa.valor(alvo) == MapaDoisBits::PROXIMO;
+
+            // Troca de nível palavra a palavra, contando a nova fronteira
+            pool.executar([&](int id)
+                          {
+                size_t quantidade = 0;
+                for (size_t p = id; p < mapa.numeroPalavras(); p += threads)
+                {
+                    uint64_t palavra = mapa.palavra(p);
+                    quantidade += MapaDoisBits::proximos(palavra);
+                    mapa.definirPalavra(p, MapaDoisBits::avancarNivel(palavra));
+                }
+                novos[id] = quantidade; });
+            totalVarreduras++;
+
+            size_t fronteira = 0;
+            for (size_t quantidade : novos)
+                fronteira += quantidade;
+            if (fronteira == 0)
+                break;
+            if (enumerarTudo)
+                niveis.push_back(fronteira);
+            if (alvoNoProximo)
+            {
+                profundidadeAlvo = nivel + 1;
+                if (!enumerarTudo)
+                    break;
+            }
+        }
+        return true;
+    }
+
+    bool reconstruirTrecho(size_t origem, size_t destino, int distancia, vector<size_t> &caminho)
+    {
+        if (distancia <= 1)
+        {
+            if (distancia == 1)
+                caminho.push_back(destino);
+            return true;
+        }
+
+        // Fronteira a 'metade' passos da origem e fronteira a 'distancia - metade' passos do destino
+        int metade = distancia / 2, ignorado = -1;
+        if (!varrer(frente, origem, false, metade, estados, ignorado, false) ||
+            !varrer(tras, destino, true, distancia - metade, estados, ignorado, false, &alcance))
+            return false;
+
+        size_t meio = estados;
+        for (size_t p = 0; p < frente.numeroPalavras() && meio == estados; ++p)
+        {
+            uint64_t comuns = MapaDoisBits::atuais(frente.palavra(p)) & MapaDoisBits::atuais(tras.palavra(p));
+            if (comuns != 0)
+                meio = p * MapaDoisBits::ESTADOS_POR_PALAVRA + __builtin_ctzll(comuns) / 2;
+        }
+        if (meio == estados)
+            return false; // não acontece se 'distancia' é a distância real
+        return reconstruirTrecho(origem, meio, metade, caminho) &&
+               reconstruirTrecho(meio, destino, distancia - metade, caminho);
+    }
+};
+
+// Busca em Largura densa com 2 bits por estado: enumera todo o espaço
+// alcançável a partir do estado inicial, informa a profundidade do objetivo e
+// reconstrói um caminho ótimo. Se o espaço completo não couber na memória
+// configurada, recorre à Busca em Largura.
+ResultadoBusca buscaEmLarguraDensa(const vector<Capacidade> &jarros, int numThreads)
+{
+    Instancia inst = criarInstancia(jarros);
+    size_t memoria = max(configuracao.memoriaBfsDensa, static_cast<size_t>(1) << 16);
+    // Todos os mapas de 2 bits por estado precisam caber juntos
+    size_t estados = TabelaRetrograda::numeroEstados(inst, memoria / LarguraDensa::MAPAS * 4);
+    if (estados == 0)
+    {
+        ResultadoBusca resultado = buscaEmLargura(jarros);
+        resultado.metodo = "Busca em Largura (espaco nao cabe no mapa de 2 bits)";
+        return resultado;
+    }
+
+    auto start = high_resolution_clock::now();
+    int threads = threadsDisponiveis(numThreads);
+    PoolThreads pool(threads);
+    LarguraDensa busca(inst, estados, pool);
+
+    vector<int> estadoInicial = converterEstado(jarros);
+    size_t origem = busca.indice(estadoInicial.data());
+    size_t objetivo = objetivoCabe(inst) ? busca.indice(inst.objetivo.data()) : estados;
+
+    ResultadoBusca resultado;
+    resultado.metodo = "Busca em Largura Densa";
+    resultado.threads = threads;
+    int profundidade = -1;
+    resultado.interrompida = !busca.enumerar(origem, objetivo, profundidade);
+    long long expandidosEnumeracao = busca.expandidos(), geradosEnumeracao = busca.gerados();
+
+    auto inicioCaminho = high_resolution_clock::now();
+    vector<size_t> caminho;
+    if (!resultado.interrompida && profundidade >= 0)
+    {
+        if (busca.reconstruir(origem, objetivo, profundidade, caminho))
+        {
+            resultado.encontrou = true;
+            resultado.custo = profundidade;
+            for (size_t estado : caminho)
+            {
+                vector<int> niveis(inst.n);
+                busca.decodificar(estado, niveis.data());
+                resultado.caminho.push_back(niveis);
+            }
+        }
+        else
+            resultado.interrompida = true;
+    }
+    auto fim = high_resolution_clock::now();
+
+    const vector<size_t> &niveis = busca.tamanhosNiveis();
+    size_t alcancaveis = 0, maiorNivel = 0;
+    for (size_t quantidade : niveis)
+    {
+        alcancaveis += quantidade;
+        maiorNivel = max(maiorNivel, quantidade);
+    }
+    resultado.nosVisitados = static_cast<int>(min(alcancaveis, static_cast<size_t>(numeric_limits<int>::max())));
+    resultado.nosExpandidos = static_cast<int>(min(expandidosEnumeracao, static_cast<long long>(numeric_limits<int>::max())));
+    resultado.tempoMicros = duration_cast<microseconds>(fim - start).count();
+    // As métricas somam a enumeração e a reconstrução do caminho; cada estado
+    // gerado na enumeração que não entrou num nível novo já estava marcado
+    resultado.metricas.instrumentada = true;
+    resultado.metricas.expandidos = busca.expandidos();
+    resultado.metricas.gerados = busca.gerados();
+    resultado.metricas.duplicados = max(0LL, geradosEnumeracao - static_cast<long long>(alcancaveis) + 1);
+    resultado.metricas.maiorVisitados = alcancaveis;
+    resultado.metricas.maiorAberta = maiorNivel;
+    resultado.metricas.bytes = busca.bytes();
+    resultado.detalhes.push_back({"Estados no espaco completo", to_string(estados)});
+    resultado.detalhes.push_back({"Estados alcancaveis", to_string(alcancaveis)});
+    resultado.detalhes.push_back({"Niveis da enumeracao", to_string(niveis.size())});
+    resultado.detalhes.push_back({"Maior nivel", to_string(maiorNivel) + " estados"});
+    resultado.detalhes.push_back({"Profundidade do objetivo", profundidade >= 0 ? to_string(profundidade) : "inalcancavel"});
+    resultado.detalhes.push_back({"Varreduras do mapa", to_string(busca.varreduras())});
+    resultado.detalhes.push_back({"Tempo de reconstrucao do caminho", to_string(duration_cast<microseconds>(fim - inicioCaminho).count()) + " us"});
+    resultado.detalhes.push_back({"Tamanho dos mapas", to_string(busca.bytes()) + " bytes"});
+    return resultado;
+}
+
+// Algoritmo que pode ser escolhido pelo nome nos modos não interativos
+struct AlgoritmoNomeado
+{
+    string nome;
+    function<ResultadoBusca(const vector<Capacidade> &)> executar;
+    // Respeita configuracao.profundidadeMaximaBacktracking: com limite, um
+    // "sem solução" só diz que não há solução dentro dele
+    bool limitaProfundidade = false;
+};
+
+// Definida adiante: o portfólio escolhe os participantes por procurarAlgoritmo
+ResultadoBusca buscaPortfolio(const vector<Capacidade> &jarros);
+
+const vector<AlgoritmoNomeado> &algoritmosDisponiveis()
+{
+    static const vector<AlgoritmoNomeado> algoritmos = {
+        {"bfs", buscaEmLargura},
+        {"dfs", buscaEmProfundidade},
+        {"backtracking", [](const vector<Capacidade> &jarros)
+         { return buscaBacktracking(jarros, configuracao.profundidadeMaximaBacktracking); }, true},
+        {"ucs", buscaOrdenada},
+        {"gulosa", buscaGulosa},
+        {"astar", buscaAEstrela},
+        {"bidirecional", buscaBidirecional},
+        {"bfs-paralela", [](const vector<Capacidade> &jarros)
+         { return buscaEmLarguraParalela(jarros, 0); }},
+        {"hda", [](const vector<Capacidade> &jarros)
+         { return buscaHDA(jarros, 0, true); }},
+        {"hda-ucs", [](const vector<Capacidade> &jarros)
+         { return buscaHDA(jarros, 0, false); }},
+        {"ida", [](const vector<Capacidade> &jarros)
+         { return buscaIDAEstrela(jarros, true); }},
+        {"bfs-externa", buscaEmLarguraExterna},
+        {"retrograda", buscaTabelaRetrograda},
+        {"bfs-densa", [](const vector<Capacidade> &jarros)
+         { return buscaEmLarguraDensa(jarros, 0); }},
+        {"anytime", [](const vector<Capacidade> &jarros)
+         { return buscaAnytime(jarros, nullptr); }},
+        {"fronteira", buscaFronteira},
+        {"ucs-parcial", [](const vector<Capacidade> &jarros)
+         { return buscaExpansaoParcial(jarros, "Busca Ordenada (expansao parcial)", 1, 0); }},
+        {"gulosa-parcial", [](const vector<Capacidade> &jarros)
+         { return buscaExpansaoParcial(jarros, "Busca Gulosa (expansao parcial)", 0, 1); }},
+        {"astar-parcial", [](const vector<Capacidade> &jarros)
+         { return buscaExpansaoParcial(jarros, "A* (expansao parcial)", 1, 1); }},
+        {"incremental", buscaIncremental},
+        {"dfs-paralela", [](const vector<Capacidade> &jarros)
+         { return buscaEmProfundidadeParalela(jarros, 0); }},
+        {"backtracking-paralelo", [](const vector<Capacidade> &jarros)
+         { return buscaEmProfundidadeParalela(jarros, 0, configuracao.profundidadeMaximaBacktracking); }, true},
+        {"portfolio", buscaPortfolio},
+    };
+    return algoritmos;
+}
+
+const AlgoritmoNomeado *procurarAlgoritmo(const string &nome)
+{
+    for (const auto &algoritmo : algoritmosDisponiveis())
+    {
+        if (algoritmo.nome == nome)
+            return &algoritmo;
+    }
+    return nullptr;
+}
+
+// Indica se o algoritmo só devolve soluções de custo mínimo. A*, IDA* e a
+// busca anytime dependem do banco de padrões, a única heurística admissível.
+bool garanteOtimo(const string &nome)
+{
+    static const vector<string> otimos = {"bfs", "ucs", "bidirecional", "bfs-paralela", "hda-ucs", "bfs-externa",
+                                          "retrograda", "bfs-densa", "fronteira", "incremental", "ucs-parcial"};
+    static const vector<string> otimosComPadroes = {"astar", "hda", "ida", "astar-parcial", "anytime"};
+    if (find(otimos.begin(), otimos.end(), nome) != otimos.end())
+        return true;
+    return configuracao.heuristica == HEURISTICA_PADROES &&
+           find(otimosComPadroes.begin(), otimosComPadroes.end(), nome) != otimosComPadroes.end();
+}
+
+// Vitórias de cada algoritmo nas corridas do portfólio, acumuladas no
+// processo (um lote ou um serviço inteiro) para ordenar as corridas seguintes
+class EstatisticasPortfolio
+{
+public:
+    void registrar(const vector<string> &participantes, const string &vencedor, long long micros)
+    {
+        lock_guard<mutex> guarda(trava);
+        for (const string &nome : participantes)
+            placar[nome].corridas++;
+        if (!vencedor.empty())
+        {
+            placar[vencedor].vitorias++;
+            placar[vencedor].microsVitorias += micros;
+        }
+        corridas++;
+    }
+
+    // Ordena os participantes pela taxa de vitórias (com correção de Laplace,
+    // para um algoritmo novo não começar nem no topo nem no fim); empates
+    // mantêm a ordem configurada
+    vector<string> ordenar(vector<string> nomes)
+    {
+        lock_guard<mutex> guarda(trava);
+        auto taxa = [&](const string &nome)
+        {
+            auto it = placar.find(nome);
+            return it == placar.end() ? 0.5 : (it->second.vitorias + 1.0) / (it->second.corridas + 2.0);
+        };
+        stable_sort(nomes.begin(), nomes.end(), [&](const string &a, const string &b)
+                    { return taxa(a) > taxa(b); });
+        return nomes;
+    }
+
+    bool vazia()
+    {
+        lock_guard<mutex> guarda(trava);
+        return corridas == 0;
+    }
+
+    // "nome vitorias/corridas (tempo médio das vitórias)" de cada algoritmo
+    string resumo()
+    {
+        lock_guard<mutex> guarda(trava);
+        string texto = to_string(corridas) + " corridas;";
+        for (const auto &[nome, placarAlgoritmo] : placar)
+        {
+            texto += " " + nome + " " + to_string(placarAlgoritmo.vitorias) + "/" + to_string(placarAlgoritmo.corridas);
+            if (placarAlgoritmo.vitorias > 0)
+                texto += " (" + to_string(placarAlgoritmo.microsVitorias / placarAlgoritmo.vitorias) + " us)";
+        }
+        return texto;
+    }
+
+private:
+    struct Placar
+    {
+        long long corridas = 0, vitorias = 0, microsVitorias = 0;
+    };
+    mutex trava;
+    map<string, Placar> placar;
+    long long corridas = 0;
+};
+
+EstatisticasPortfolio estatisticasPortfolio;
+
+// Portfólio: roda vários algoritmos ao mesmo tempo, cada um em sua thread e
+// com seu próprio controle (orçamento de nós opcional em "nome:limite"), e
+// devolve o primeiro resultado aceitável: qualquer solução, ou só uma de
+// otimalidade garantida com configuracao.portfolioOtimo. Um "sem solução" de
+// uma busca completa também encerra a corrida. Os demais participantes são
+// cancelados pelo sinal do ControleBusca e a função espera todos pararem.
+// Com corredoresPortfolio > 0, só essa quantidade corre de cada vez, na ordem
+// das vitórias anteriores; os outros entram quando um termina sem resultado.
+ResultadoBusca buscaPortfolio(const vector<Capacidade> &jarros)
+{
+    auto start = high_resolution_clock::now();
+    struct Participante
+    {
+        string nome;
+        const AlgoritmoNomeado *algoritmo = nullptr;
+        long long limiteNos = 0;
+        ResultadoBusca resultado;
+        bool iniciado = false, terminou = false;
+        long long micros = 0;
+    };
+
+    vector<string> nomes, ignorados;
+    map<string, long long> limites;
+    istringstream lista(configuracao.algoritmosPortfolio);
+    string item;
+    while (getline(lista, item, ','))
+    {
+        string nome = item.substr(0, item.find(':'));
+        nome.erase(remove(nome.begin(), nome.end(), ' '), nome.end());
+        if (nome.empty())
+            continue;
+        if (nome == "portfolio" || !procurarAlgoritmo(nome) || find(nomes.begin(), nomes.end(), nome) != nomes.end())
+        {
+            ignorados.push_back(nome);
+            continue;
+        }
+        nomes.push_back(nome);
+        if (item.find(':') != string::npos)
+            limites[nome] = atoll(item.substr(item.find(':') + 1).c_str());
+    }
+    if (nomes.empty())
+    {
+        ResultadoBusca resultado;
+        resultado.metodo = "Portfolio (nenhum algoritmo valido em '" + configuracao.algoritmosPortfolio + "')";
+        return resultado;
+    }
+
+    vector<Participante> participantes;
+    for (const string &nome : estatisticasPortfolio.ordenar(nomes))
+    {
+        Participante participante;
+        participante.nome = nome;
+        participante.algoritmo = procurarAlgoritmo(nome);
+        participante.limiteNos = limites[nome];
+        participantes.push_back(move(participante));
+    }
+
+    bool exigirOtimo = configuracao.portfolioOtimo;
+    auto aceitavel = [&](const Participante &participante)
+    {
+        const ResultadoBusca &resultado = participante.resultado;
+        if (resultado.encontrou)
+            return !exigirOtimo || (!resultado.interrompida && garanteOtimo(participante.nome));
+        // "Sem solução" só prova algo se a busca foi até o fim e não tinha limite de profundidade
+        return !resultado.interrompida &&
+               !(participante.algoritmo->limitaProfundidade && configuracao.profundidadeMaximaBacktracking > 0);
+    };
+
+    const ControleBusca *externo = controleAtual;
+    size_t corredores = configuracao.corredoresPortfolio > 0 ? static_cast<size_t>(configuracao.corredoresPortfolio)
+                                                             : participantes.size();
+    atomic<bool> cancelar(false);
+    mutex trava;
+    condition_variable terminou;
+    int vencedor = -1;
+    size_t proximo = 0, ativos = 0;
+    vector<thread> threads;
+
+    auto correr = [&](size_t k)
+    {
+        Participante &participante = participantes[k];
+        ControleBusca controle;
+        controle.cancelar = &cancelar;
+        if (externo)
+        {
+            controle.prazo = externo->prazo;
+            controle.limiteNos = externo->limiteNos;
+        }
+        if (participante.limiteNos > 0)
+            controle.limiteNos = participante.limiteNos;
+        EscopoControle escopo(&controle);
+        auto inicio = high_resolution_clock::now();
+        ResultadoBusca resultado = participante.algoritmo->executar(jarros);
+        long long micros = duration_cast<microseconds>(high_resolution_clock::now() - inicio).count();
+
+        lock_guard<mutex> guarda(trava);
+        participante.resultado = move(resultado);
+        participante.micros = micros;
+        participante.terminou = true;
+        ativos--;
+        if (vencedor < 0 && !cancelar && aceitavel(participante))
+        {
+            vencedor = static_cast<int>(k);
+            cancelar = true;
+        }
+        terminou.notify_one();
+    };
+
+    {
+        unique_lock<mutex> guarda(trava);
+        while (true)
+        {
+            while (!cancelar && proximo < participantes.size() && ativos < corredores)
+            {
+                participantes[proximo].iniciado = true;
+                ativos++;
+                threads.emplace_back(correr, proximo++);
+            }
+            if (ativos == 0 && (cancelar || proximo == participantes.size()))
+                break;
+            // Acorda de tempos em tempos para repassar o prazo ou o cancelamento externos
+            terminou.wait_for(guarda, milliseconds(10));
+            if (externo && externo->deveParar())
+                cancelar = true;
+        }
+    }
+    for (auto &t : threads)
+        t.join();
+
+    // Sem vencedor: a solução de menor custo encontrada, ou o primeiro resultado
+    int escolhido = vencedor;
+    for (size_t k = 0; vencedor < 0 && k < participantes.size(); ++k)
+    {
+        const ResultadoBusca &candidato = participantes[k].resultado;
+        if (participantes[k].terminou && candidato.encontrou &&
+            (escolhido < 0 || candidato.custo < participantes[escolhido].resultado.custo))
+            escolhido = static_cast<int>(k);
+    }
+    if (escolhido < 0)
+        escolhido = 0;
+
+    vector<string> corredoresUsados;
+    for (const auto &participante : participantes)
+    {
+        if (participante.iniciado)
+            corredoresUsados.push_back(participante.nome);
+    }
+    long long microsTotal = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    estatisticasPortfolio.registrar(corredoresUsados, vencedor >= 0 ? participantes[vencedor].nome : "",
+                                    vencedor >= 0 ? participantes[vencedor].micros : 0);
+
+    ResultadoBusca resultado = participantes[escolhido].resultado;
+    resultado.metodo = "Portfolio: " + resultado.metodo;
+    resultado.tempoMicros = microsTotal;
+    if (vencedor < 0)
+        resultado.interrompida = true; // nenhum participante chegou a um resultado aceitável
+    resultado.detalhes.push_back({"Aceitacao", exigirOtimo ? "somente solucao otima" : "qualquer solucao"});
+    resultado.detalhes.push_back({"Vencedor", vencedor >= 0 ? participantes[vencedor].nome : "nenhum"});
+    for (const auto &participante : participantes)
+    {
+        string situacao;
+        if (!participante.iniciado)
+            situacao = "nao iniciado";
+        else if (static_cast<int>(&participante - participantes.data()) == vencedor)
+            situacao = "venceu em " + to_string(participante.micros) + " us";
+        else if (participante.resultado.interrompida)
+            situacao = "cancelado apos " + to_string(participante.micros) + " us";
+        else if (aceitavel(participante))
+            situacao = "terminou em " + to_string(participante.micros) + " us, depois do vencedor";
+        else
+            situacao = "terminou em " + to_string(participante.micros) + " us sem resultado aceitavel";
+        resultado.detalhes.push_back({"Participante " + participante.nome, situacao});
+    }
+    for (const string &nome : ignorados)
+        resultado.detalhes.push_back({"Participante " + nome, "ignorado (desconhecido ou repetido)"});
+    resultado.detalhes.push_back({"Placar do portfolio", estatisticasPortfolio.resumo()});
+    return resultado;
+}
+
+// Lê uma lista de inteiros separados por espaços
+vector<int> lerInteiros(const string &texto, bool &valido)
+{
+    vector<int> valores;
+    istringstream entrada(texto);
+    int valor;
+    while (entrada >> valor)
+        valores.push_back(valor);
+    valido = entrada.eof();
+    return valores;
+}
+
+// Interpreta uma linha "algoritmo; capacidades; objetivos; níveis iniciais",
+// por exemplo "bfs; 4 3 9; 0 2 0; 0 0 0"
+bool lerLinhaLote(const string &linha, string &algoritmo, vector<Capacidade> &jarros, string &erro)
+{
+    vector<string> partes;
+    string parte;
+    istringstream entrada(linha);
+    while (getline(entrada, parte, ';'))
+        partes.push_back(parte);
+    if (partes.size() != 4)
+    {
+        erro = "esperado: algoritmo; capacidades; objetivos; niveis iniciais";
+        return false;
+    }
+
+    istringstream(partes[0]) >> algoritmo;
+    bool validos[3];
+    vector<int> capacidades = lerInteiros(partes[1], validos[0]);
+    vector<int> objetivos = lerInteiros(partes[2], validos[1]);
+    vector<int> niveis = lerInteiros(partes[3], validos[2]);
+    if (!validos[0] || !validos[1] || !validos[2] || capacidades.empty() ||
+        objetivos.size() != capacidades.size() || niveis.size() != capacidades.size())
+    {
+        erro = "listas de inteiros invalidas ou de tamanhos diferentes";
+        return false;
+    }
+
+    jarros.assign(capacidades.size(), Capacidade());
+    for (size_t i = 0; i < capacidades.size(); ++i)
+    {
+        if (capacidades[i] < 0 || niveis[i] < 0 || niveis[i] > capacidades[i])
+        {
+            erro = "nivel fora da capacidade do jarro " + to_string(i + 1);
+            return false;
+        }
+        if (objetivos[i] < 0 || objetivos[i] > capacidades[i])
+        {
+            erro = "objetivo fora da capacidade do jarro " + to_string(i + 1);
+            return false;
+        }
+        jarros[i] = {niveis[i], capacidades[i], objetivos[i]};
+    }
+    return true;
+}
+
+// Resolve uma linha no formato do lote e devolve os campos JSON da resposta
+// (começando por vírgula): o algoritmo e o resultado, ou o status de erro
+string resolverLinhaJson(const string &linha, long long tempoLimiteMs, long long limiteNos, bool *sucesso = nullptr,
+                         bool incluirCaminho = true)
+{
+    string algoritmo, erro;
+    vector<Capacidade> jarros;
+    const AlgoritmoNomeado *escolhido = nullptr;
+    if (lerLinhaLote(linha, algoritmo, jarros, erro) && !(escolhido = procurarAlgoritmo(algoritmo)))
+        erro = "algoritmo desconhecido: " + algoritmo;
+    if (sucesso)
+        *sucesso = escolhido != nullptr;
+    if (!escolhido)
+        return ",\"status\":\"erro\",\"mensagem\":" + textoJson(erro);
+
+    ControleBusca controle;
+    if (tempoLimiteMs > 0)
+        controle.prazo = high_resolution_clock::now() + milliseconds(tempoLimiteMs);
+    controle.limiteNos = limiteNos;
+    EscopoControle escopo(&controle);
+    ResultadoBusca resultado = escolhido->executar(jarros);
+    return ",\"algoritmo\":" + textoJson(algoritmo) + "," + camposJson(resultado, incluirCaminho);
+}
+
+struct OpcoesLote
+{
+    string arquivo = "-"; // "-" = entrada padrão
+    int threads = 0;      // 0 = automático
+    long long tempoLimiteMs = 0; // por instância; 0 = sem limite
+    long long limiteNos = 0;     // por instância; 0 = sem limite
+};
+
+// Modo em lote: lê instâncias (uma por linha) de um arquivo ou da entrada
+// padrão, resolve-as em paralelo em um conjunto de threads e escreve uma
+// linha JSON por instância assim que ela termina (na ordem de término)
+int executarLote(const OpcoesLote &opcoes)
+{
+    ifstream arquivo;
+    if (opcoes.arquivo != "-")
+    {
+        arquivo.open(opcoes.arquivo);
+        if (!arquivo)
+        {
+            cerr << "Nao foi possivel abrir " << opcoes.arquivo << endl;
+            return 1;
+        }
+    }
+    istream &entrada = opcoes.arquivo == "-" ? cin : arquivo;
+
+    int threads = threadsDisponiveis(opcoes.threads);
+    const size_t limiteFila = static_cast<size_t>(threads) * 4;
+    deque<pair<long long, string>> fila; // {número da linha, texto}
+    bool fimEntrada = false;
+    mutex travaFila, travaSaida;
+    condition_variable temTrabalho, temEspaco;
+    atomic<long long> resolvidas(0);
+
+    auto trabalhador = [&]
+    {
+        while (true)
+        {
+            pair<long long, string> item;
+            {
+                unique_lock<mutex> guarda(travaFila);
+                temTrabalho.wait(guarda, [&]
+                                 { return fimEntrada || !fila.empty(); });
+                if (fila.empty())
+                    return;
+                item = move(fila.front());
+                fila.pop_front();
+            }
+            temEspaco.notify_one();
+
+            string linhaJson = "{\"linha\":" + to_string(item.first) +
+                               resolverLinhaJson(item.second, opcoes.tempoLimiteMs, opcoes.limiteNos) + "}";
+            resolvidas++;
+
+            lock_guard<mutex> guarda(travaSaida);
+            cout << linhaJson << '\n'
+                 << flush;
+        }
+    };
+
+    auto inicio = high_resolution_clock::now();
+    vector<thread> trabalhadores;
+    for (int id = 0; id < threads; ++id)
+        trabalhadores.emplace_back(trabalhador);
+
+    string linha;
+    long long numeroLinha = 0;
+    while (getline(entrada, linha))
+    {
+        numeroLinha++;
+        size_t primeiro = linha.find_first_not_of(" \t\r");
+        if (primeiro == string::npos || linha[primeiro] == '#')
+            continue; // linha vazia ou comentário
+        unique_lock<mutex> guarda(travaFila);
+        temEspaco.wait(guarda, [&]
+                       { return fila.size() < limiteFila; });
+        fila.emplace_back(numeroLinha, linha);
+        guarda.unlock();
+        temTrabalho.notify_one();
+    }
+    {
+        lock_guard<mutex> guarda(travaFila);
+        fimEntrada = true;
+    }
+    temTrabalho.notify_all();
+    for (auto &t : trabalhadores)
+        t.join();
+
+    double segundos = duration_cast<microseconds>(high_resolution_clock::now() - inicio).count() / 1e6;
+    cerr << "Instancias resolvidas: " << resolvidas.load() << " em " << segundos << " s ("
+         << (segundos > 0 ? resolvidas.load() / segundos : 0) << " por segundo, " << threads << " threads)" << endl;
+    if (!estatisticasPortfolio.vazia())
+        cerr << "Portfolio: " << estatisticasPortfolio.resumo() << endl;
+    return 0;
+}
+
+struct OpcoesServico
+{
+    string socket;               // vazio = entrada e saída padrão
+    long long tempoLimiteMs = 0; // por pedido; 0 = sem limite
+    long long limiteNos = 0;     // por pedido; 0 = sem limite
+    bool caminho = true;         // inclui o caminho da solução na resposta
+};
+
+// Latências dos pedidos atendidos pelo serviço; guarda as últimas AMOSTRAS
+// para os percentis e os totais desde o início
+class EstatisticasServico
+{
+public:
+    static constexpr size_t AMOSTRAS = 4096;
+
+    void registrar(long long micros, bool sucesso)
+    {
+        lock_guard<mutex> guarda(trava);
+        if (latencias.size() < AMOSTRAS)
+            latencias.push_back(micros);
+        else
+            latencias[static_cast<size_t>(pedidos % AMOSTRAS)] = micros;
+        pedidos++;
+        erros += sucesso ? 0 : 1;
+        maior = max(maior, micros);
+    }
+
+    string json()
+    {
+        vector<long long> ordenadas;
+        string texto;
+        long long maiorLatencia = 0;
+        {
+            lock_guard<mutex> guarda(trava);
+            ordenadas = latencias;
+            maiorLatencia = maior;
+            texto = "{\"pedidos\":" + to_string(pedidos) + ",\"erros\":" + to_string(erros);
+        }
+        sort(ordenadas.begin(), ordenadas.end());
+        auto percentil = [&](int p)
+        {
+            return ordenadas.empty() ? 0LL : ordenadas[(ordenadas.size() - 1) * p / 100];
+        };
+        texto += ",\"latencia_us\":{\"p50\":" + to_string(percentil(50)) + ",\"p90\":" + to_string(percentil(90)) +
+                 ",\"p99\":" + to_string(percentil(99)) + ",\"max\":" + to_string(maiorLatencia) + "}";
+        texto += ",\"cache_retrogrado\":" + textoJson(cacheRetrogrado.resumo());
+        texto += ",\"portfolio\":" + textoJson(estatisticasPortfolio.resumo()) + "}";
+        return texto;
+    }
+
+private:
+    mutex trava;
+    vector<long long> latencias;
+    long long pedidos = 0, erros = 0, maior = 0;
+};
+
+// Atende um pedido do serviço e devolve a linha de resposta (sem o '\n').
+// Comandos: "estatisticas" responde com os percentis de latência; "sair"
+// encerra a conexão e "encerrar" o serviço (respostas vazias sinalizam isso).
+// Linhas vazias e comentários não têm resposta; linhas com mais de
+// LIMITE_LINHA_SERVICO bytes recebem status de erro sem serem lidas.
+const size_t LIMITE_LINHA_SERVICO = 64 * 1024;
+
+enum AcaoServico
+{
+    SERVICO_RESPONDER,
+    SERVICO_IGNORAR,
+    SERVICO_SAIR,
+    SERVICO_ENCERRAR
+};
+
+AcaoServico atenderPedido(const string &linha, long long numero, const OpcoesServico &opcoes,
+                          EstatisticasServico &estatisticas, string &resposta)
+{
+    if (linha.size() > LIMITE_LINHA_SERVICO)
+    {
+        estatisticas.registrar(0, false);
+        resposta = "{\"pedido\":" + to_string(numero) + ",\"status\":\"erro\",\"mensagem\":" +
+                   textoJson("linha com mais de " + to_string(LIMITE_LINHA_SERVICO) + " bytes") + "}";
+        return SERVICO_RESPONDER;
+    }
+    size_t primeiro = linha.find_first_not_of(" \t\r");
+    if (primeiro == string::npos || linha[primeiro] == '#')
+        return SERVICO_IGNORAR;
+    size_t ultimo = linha.find_last_not_of(" \t\r");
+    string comando = linha.substr(primeiro, ultimo - primeiro + 1);
+    if (comando == "sair")
+        return SERVICO_SAIR;
+    if (comando == "encerrar")
+        return SERVICO_ENCERRAR;
+    if (comando == "estatisticas")
+    {
+        resposta = estatisticas.json();
+        return SERVICO_RESPONDER;
+    }
+
+    auto inicio = high_resolution_clock::now();
+    bool sucesso = false;
+    string campos = resolverLinhaJson(linha, opcoes.tempoLimiteMs, opcoes.limiteNos, &sucesso, opcoes.caminho);
+    long long micros = duration_cast<microseconds>(high_resolution_clock::now() - inicio).count();
+    estatisticas.registrar(micros, sucesso);
+    resposta = "{\"pedido\":" + to_string(numero) + campos + ",\"latencia_us\":" + to_string(micros) + "}";
+    return SERVICO_RESPONDER;
+}
+
+#ifndef _WIN32
+// Escreve todo o texto no descritor, repetindo nas escritas parciais
+bool escreverTudo(int descritor, const string &texto)
+{
+    size_t enviado = 0;
+    while (enviado < texto.size())
+    {
+        ssize_t escrito = write(descritor, texto.data() + enviado, texto.size() - enviado);
+        if (escrito < 0 && errno == EINTR)
+            continue;
+        if (escrito <= 0)
+            return false;
+        enviado += static_cast<size_t>(escrito);
+    }
+    return true;
+}
+
+// Serviço em um socket de domínio Unix: cada conexão ganha uma thread, que
+// lê pedidos linha a linha e responde na mesma ordem, mantendo sua memória de
+// trabalho (thread_local) quente entre os pedidos da conexão. Acima de
+// LIMITE_CONEXOES simultâneas, as novas esperam na fila do listen; as threads
+// de conexões encerradas são recolhidas antes de cada accept.
+int servirSocket(const OpcoesServico &opcoes, EstatisticasServico &estatisticas)
+{
+    static const size_t LIMITE_CONEXOES = 64;
+
+    sockaddr_un endereco{};
+    endereco.sun_family = AF_UNIX;
+    if (opcoes.socket.size() >= sizeof(endereco.sun_path))
+    {
+        cerr << "Caminho do socket longo demais: " << opcoes.socket << endl;
+        return 1;
+    }
+    strcpy(endereco.sun_path, opcoes.socket.c_str());
+
+    int servidor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (servidor < 0)
+    {
+        cerr << "Nao foi possivel criar o socket: " << strerror(errno) << endl;
+        return 1;
+    }
+    unlink(opcoes.socket.c_str()); // socket deixado por uma execução anterior
+    if (bind(servidor, reinterpret_cast<sockaddr *>(&endereco), sizeof(endereco)) != 0 || listen(servidor, 16) != 0)
+    {
+        cerr << "Nao foi possivel escutar em " << opcoes.socket << ": " << strerror(errno) << endl;
+        close(servidor);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN); // um cliente que fecha cedo não derruba o serviço
+    cerr << "Servico escutando em " << opcoes.socket << endl;
+
+    atomic<bool> encerrar(false);
+    mutex travaConexoes;
+    condition_variable conexaoTerminou;
+    vector<int> conexoes;
+    map<int, thread> atendentes; // por descritor do cliente
+    vector<thread> terminados;   // atendentes que já saíram, esperando o join
+
+    auto atender = [&](int cliente)
+    {
+        string pendente, resposta;
+        char buffer[4096];
+        long long numero = 0;
+        bool aberta = true, descartando = false; // descartando = resto de uma linha longa demais
+        while (aberta)
+        {
+            ssize_t lidos = read(cliente, buffer, sizeof(buffer));
+            if (lidos < 0 && errno == EINTR)
+                continue;
+            if (lidos <= 0)
+                break;
+            pendente.append(buffer, static_cast<size_t>(lidos));
+            size_t inicioLinha = 0, fimLinha;
+            while (aberta && (fimLinha = pendente.find('\n', inicioLinha)) != string::npos)
+            {
+                string linha = pendente.substr(inicioLinha, fimLinha - inicioLinha);
+                inicioLinha = fimLinha + 1;
+                if (descartando)
+                {
+                    descartando = false; // fim da linha já respondida com erro
+                    continue;
+                }
+                AcaoServico acao = atenderPedido(linha, ++numero, opcoes, estatisticas, resposta);
+                if (acao == SERVICO_RESPONDER)
+                    aberta = escreverTudo(cliente, resposta + "\n");
+                else if (acao == SERVICO_SAIR)
+                    aberta = false;
+                else if (acao == SERVICO_ENCERRAR)
+                {
+                    aberta = false;
+                    encerrar = true;
+                    shutdown(servidor, SHUT_RDWR); // desbloqueia o accept
+                }
+            }
+            pendente.erase(0, inicioLinha);
+            if (aberta && pendente.size() > LIMITE_LINHA_SERVICO)
+            {
+                // Sem '\n' à vista: responde o erro já e ignora o resto da linha
+                if (!descartando)
+                {
+                    atenderPedido(pendente, ++numero, opcoes, estatisticas, resposta);
+                    aberta = escreverTudo(cliente, resposta + "\n");
+                }
+                descartando = true;
+                pendente.clear();
+            }
+        }
+        // Sai do mapa antes do close: o descritor pode ser reusado pelo próximo accept
+        lock_guard<mutex> guarda(travaConexoes);
+        auto propria = atendentes.find(cliente);
+        terminados.push_back(move(propria->second));
+        atendentes.erase(propria);
+        conexoes.erase(find(conexoes.begin(), conexoes.end(), cliente));
+        close(cliente);
+        conexaoTerminou.notify_all();
+    };
+
+    while (!encerrar)
+    {
+        vector<thread> recolher;
+        {
+            unique_lock<mutex> guarda(travaConexoes);
+            conexaoTerminou.wait(guarda, [&]
+                                 { return conexoes.size() < LIMITE_CONEXOES || encerrar; });
+            recolher.swap(terminados);
+        }
+        for (auto &t : recolher)
+            t.join();
+        if (encerrar)
+            break;
+
+        int cliente = accept(servidor, nullptr, nullptr);
+        if (cliente < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            break;
+        }
+        // A thread só procura a si mesma no mapa depois de pegar a trava
+        lock_guard<mutex> guarda(travaConexoes);
+        conexoes.push_back(cliente);
+        atendentes.emplace(cliente, thread(atender, cliente));
+    }
+
+    // Acorda as conexões ainda abertas e espera todas as threads saírem
+    {
+        unique_lock<mutex> guarda(travaConexoes);
+        for (int cliente : conexoes)
+            shutdown(cliente, SHUT_RDWR);
+        conexaoTerminou.wait(guarda, [&]
+                             { return conexoes.empty(); });
+    }
+    for (auto &t : terminados)
+        t.join();
+    close(servidor);
+    unlink(opcoes.socket.c_str());
+    return 0;
+}
+#endif
+
+// Modo serviço: um processo de longa duração que atende pedidos no formato
+// das linhas do lote, pela entrada padrão ou por um socket local, com uma
+// resposta JSON por linha. Ao contrário do lote, que paga a inicialização do
+// processo e das estruturas a cada execução, aqui a memória de trabalho das
+// buscas (tabelas, vetores de nós, listas abertas), os bancos de padrões e as
+// tabelas retrógradas ficam quentes de um pedido para o outro.
+int executarServico(const OpcoesServico &opcoes)
+{
+    EstatisticasServico estatisticas;
+    int codigo = 0;
+    if (!opcoes.socket.empty())
+    {
+#ifdef _WIN32
+        cerr << "Sockets locais nao sao suportados nesta plataforma; use a entrada padrao" << endl;
+        codigo = 1;
+#else
+        codigo = servirSocket(opcoes, estatisticas);
+#endif
+    }
+    else
+    {
+        string linha, resposta;
+        long long numero = 0;
+        while (getline(cin, linha))
+        {
+            AcaoServico acao = atenderPedido(linha, ++numero, opcoes, estatisticas, resposta);
+            if (acao == SERVICO_SAIR || acao == SERVICO_ENCERRAR)
+                break;
+            if (acao == SERVICO_RESPONDER)
+                cout << resposta << '\n'
+                     << flush;
+        }
+    }
+    cerr << "Servico encerrado: " << estatisticas.json() << endl;
+    return codigo;
+}
+
+// Gerador pseudoaleatório reprodutível (splitmix64): a mesma semente produz as
+// mesmas instâncias em qualquer compilador, o que as distribuições da
+// biblioteca padrão não garantem
+class GeradorAleatorio
+{
+public:
+    explicit GeradorAleatorio(uint64_t semente) : estado(semente) {}
+
+    uint64_t proximo()
+    {
+        estado += 0x9e3779b97f4a7c15ULL;
+        return misturarBits(estado);
+    }
+
+    // Inteiro uniforme (a menos de um viés desprezível) em [minimo, maximo]
+    int entre(int minimo, int maximo)
+    {
+        return minimo + static_cast<int>(proximo() % static_cast<uint64_t>(maximo - minimo + 1));
+    }
+
+private:
+    uint64_t estado;
+};
+
+// Pico de memória residente do processo em KB (0 se não disponível). O valor
+// só cresce durante a execução, então vale para tudo o que rodou até aqui.
+long long picoMemoriaKB()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS contadores;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &contadores, sizeof(contadores)))
+        return static_cast<long long>(contadores.PeakWorkingSetSize / 1024);
+    return 0;
+#else
+    struct rusage uso;
+    if (getrusage(RUSAGE_SELF, &uso) != 0)
+        return 0;
+#ifdef __APPLE__
+    return uso.ru_maxrss / 1024; // o macOS informa em bytes
+#else
+    return uso.ru_maxrss;
+#endif
+#endif
+}
+
+// Pico de memória residente acrescentado por uma execução, em KB. A execução
+// roda num processo filho (fork) e o valor é o pico do filho menos o que ele
+// já tinha ao começar, então não carrega o pico das execuções anteriores do
+// benchmark e pode ser comparado entre algoritmos e entre versões. -1 se não
+// puder ser medido (Windows, ou falha ao criar o processo).
+long long medirPicoExecucao(const function<void()> &executar)
+{
+#ifdef _WIN32
+    (void)executar;
+    return -1;
+#else
+    int canal[2];
+    if (pipe(canal) != 0)
+        return -1;
+    pid_t filho = fork();
+    if (filho < 0)
+    {
+        close(canal[0]);
+        close(canal[1]);
+        return -1;
+    }
+    if (filho == 0)
+    {
+        // _exit no filho: nada dos buffers de saída herdados é escrito de novo
+        close(canal[0]);
+        long long antes = picoMemoriaKB();
+        executar();
+        long long acrescimo = picoMemoriaKB() - antes;
+        bool escreveu = write(canal[1], &acrescimo, sizeof(acrescimo)) == static_cast<ssize_t>(sizeof(acrescimo));
+        _exit(escreveu ? 0 : 1);
+    }
+    close(canal[1]);
+    long long acrescimo = -1;
+    if (read(canal[0], &acrescimo, sizeof(acrescimo)) != static_cast<ssize_t>(sizeof(acrescimo)))
+        acrescimo = -1;
+    close(canal[0]);
+    int estado = 0;
+    waitpid(filho, &estado, 0);
+    return acrescimo;
+#endif
+}
+
+struct OpcoesBenchmark
+{
+    uint64_t semente = 1;
+    int instancias = 20;
+    int minJarros = 2, maxJarros = 4;
+    int minCapacidade = 3, maxCapacidade = 30;
+    int percentualInsoluveis = 25;
+    int aquecimento = 1;
+    int repeticoes = 5;
+    long long tempoLimiteMs = 0; // por execução; 0 = sem limite
+    long long limiteNos = 0;     // por execução; 0 = sem limite
+    string algoritmos = "bfs,dfs,backtracking,ucs,gulosa,astar";
+    string formato = "csv"; // csv ou json
+    string saida = "-";     // "-" = saída padrão
+};
+
+// Fatores das instâncias insolúveis que têm algum múltiplo no intervalo de capacidades
+vector<int> fatoresInsoluveis(const OpcoesBenchmark &opcoes)
+{
+    vector<int> fatores;
+    for (int fator : {2, 3})
+    {
+        if ((opcoes.minCapacidade + fator - 1) / fator <= opcoes.maxCapacidade / fator)
+            fatores.push_back(fator);
+    }
+    return fatores;
+}
+
+// Gera uma instância do benchmark. Nas solúveis o objetivo é o estado
+// alcançado por um passeio aleatório a partir do inicial. Nas insolúveis
+// todas as capacidades e níveis iniciais são múltiplos de um fator > 1, o que
+// mantém todo nível alcançável múltiplo dele, e um dos objetivos não é; as
+// capacidades ficam no intervalo pedido, então o fator precisa caber nele
+// (ver fatoresInsoluveis, conferido em executarBenchmark).
+vector<Capacidade> gerarInstanciaBenchmark(GeradorAleatorio &aleatorio, const OpcoesBenchmark &opcoes, bool soluvel)
+{
+    int n = aleatorio.entre(opcoes.minJarros, opcoes.maxJarros);
+    vector<Capacidade> jarros(n);
+    if (soluvel)
+    {
+        for (auto &jarro : jarros)
+        {
+            jarro.capacidadeMax = aleatorio.entre(opcoes.minCapacidade, opcoes.maxCapacidade);
+            jarro.capacidadeAtual = aleatorio.entre(0, jarro.capacidadeMax);
+        }
+        Instancia inst = criarInstancia(jarros);
+        vector<Movimento> movimentos = listarMovimentos(n);
+        vector<int> niveis = converterEstado(jarros);
+        int passos = aleatorio.entre(4 * n, 16 * n);
+        for (int passo = 0; passo < passos; ++passo)
+            aplicarMovimento(inst, niveis.data(), movimentos[aleatorio.entre(0, static_cast<int>(movimentos.size()) - 1)]);
+        for (int i = 0; i < n; ++i)
+            jarros[i].objetivo = niveis[i];
+        return jarros;
+    }
+
+    vector<int> fatores = fatoresInsoluveis(opcoes);
+    int fator = fatores[aleatorio.entre(0, static_cast<int>(fatores.size()) - 1)];
+    int minimo = (opcoes.minCapacidade + fator - 1) / fator, maximo = opcoes.maxCapacidade / fator;
+    for (auto &jarro : jarros)
+    {
+        jarro.capacidadeMax = fator * aleatorio.entre(minimo, maximo);
+        jarro.capacidadeAtual = fator * aleatorio.entre(0, jarro.capacidadeMax / fator);
+        jarro.objetivo = fator * aleatorio.entre(0, jarro.capacidadeMax / fator);
+    }
+    Capacidade &escolhido = jarros[aleatorio.entre(0, n - 1)];
+    escolhido.objetivo = fator * aleatorio.entre(0, escolhido.capacidadeMax / fator - 1) + aleatorio.entre(1, fator - 1);
+    return jarros;
+}
+
+// Executa o benchmark: cada algoritmo roda sobre cada instância gerada, com
+// execuções de aquecimento descartadas e depois 'repeticoes' execuções medidas.
+// Cada linha do CSV/JSON traz a instância, o resultado e os tempos em ns; o
+// pico de memória vem de uma execução a mais, isolada num processo filho
+// antes das medidas de tempo (ver medirPicoExecucao).
+int executarBenchmark(const OpcoesBenchmark &opcoes)
+{
+    vector<const AlgoritmoNomeado *> algoritmos;
+    istringstream lista(opcoes.algoritmos);
+    string nome;
+    while (getline(lista, nome, ','))
+    {
+        const AlgoritmoNomeado *algoritmo = procurarAlgoritmo(nome);
+        if (!algoritmo)
+        {
+            cerr << "Algoritmo desconhecido: " << nome << endl;
+            return 1;
+        }
+        algoritmos.push_back(algoritmo);
+    }
+    if (opcoes.minJarros < 1 || opcoes.maxJarros < opcoes.minJarros || opcoes.minCapacidade < 1 ||
+        opcoes.maxCapacidade < opcoes.minCapacidade || opcoes.repeticoes < 1 || opcoes.aquecimento < 0 ||
+        opcoes.instancias < 0 || opcoes.percentualInsoluveis < 0 || opcoes.percentualInsoluveis > 100)
+    {
+        cerr << "Parametros do benchmark invalidos" << endl;
+        return 1;
+    }
+    if (opcoes.percentualInsoluveis > 0 && fatoresInsoluveis(opcoes).empty())
+    {
+        cerr << "Instancias insoluveis precisam de um multiplo de 2 ou 3 entre as capacidades; use --insoluveis 0" << endl;
+        return 1;
+    }
+
+    ofstream arquivo;
+    if (opcoes.saida != "-")
+    {
+        arquivo.open(opcoes.saida);
+        if (!arquivo)
+        {
+            cerr << "Nao foi possivel criar " << opcoes.saida << endl;
+            return 1;
+        }
+    }
+    ostream &saida = opcoes.saida == "-" ? cout : arquivo;
+    bool json = opcoes.formato == "json";
+
+    const vector<string> colunas = {"instancia", "jarros", "capacidades", "objetivos", "iniciais", "soluvel",
+                                    "algoritmo", "status", "profundidade", "expandidos", "visitados",
+                                    "maior_fronteira", "repeticoes", "ns_min", "ns_mediana", "ns_max",
+                                    "nos_por_segundo", "pico_rss_kb"};
+    if (json)
+    {
+        saida << "{\"semente\":" << opcoes.semente << ",\"resultados\":[" << endl;
+    }
+    else
+    {
+        for (size_t c = 0; c < colunas.size(); ++c)
+            saida << (c ? "," : "") << colunas[c];
+        saida << endl;
+    }
+
+    auto textoNiveis = [](const vector<Capacidade> &jarros, int Capacidade::*campo)
+    {
+        string texto;
+        for (const auto &jarro : jarros)
+            texto += (texto.empty() ? "" : " ") + to_string(jarro.*campo);
+        return texto;
+    };
+
+    GeradorAleatorio aleatorio(opcoes.semente);
+    bool primeiraLinha = true;
+    for (int k = 0; k < opcoes.instancias; ++k)
+    {
+        bool soluvel = aleatorio.entre(1, 100) > opcoes.percentualInsoluveis;
+        vector<Capacidade> jarros = gerarInstanciaBenchmark(aleatorio, opcoes, soluvel);
+
+        for (const AlgoritmoNomeado *algoritmo : algoritmos)
+        {
+            auto executarComLimites = [&]()
+            {
+                ControleBusca controle;
+                if (opcoes.tempoLimiteMs > 0)
+                    controle.prazo = high_resolution_clock::now() + milliseconds(opcoes.tempoLimiteMs);
+                controle.limiteNos = opcoes.limiteNos;
+                EscopoControle escopo(&controle);
+                return algoritmo->executar(jarros);
+            };
+            long long picoKB = medirPicoExecucao([&]()
+                                                 { executarComLimites(); });
+
+            ResultadoBusca resultado;
+            vector<long long> tempos;
+            for (int execucao = 0; execucao < opcoes.aquecimento + opcoes.repeticoes; ++execucao)
+            {
+                auto inicio = high_resolution_clock::now();
+                resultado = executarComLimites();
+                long long nanos = duration_cast<nanoseconds>(high_resolution_clock::now() - inicio).count();
+                if (execucao >= opcoes.aquecimento)
+                    tempos.push_back(nanos);
+            }
+            sort(tempos.begin(), tempos.end());
+            long long mediana = tempos[tempos.size() / 2];
+
+            string status = statusResultado(resultado);
+            vector<string> valores = {
+                to_string(k), to_string(jarros.size()), textoNiveis(jarros, &Capacidade::capacidadeMax),
+                textoNiveis(jarros, &Capacidade::objetivo), textoNiveis(jarros, &Capacidade::capacidadeAtual),
+                soluvel ? "1" : "0", algoritmo->nome, status,
+                resultado.encontrou ? to_string(resultado.caminho.size() - 1) : "",
+                to_string(resultado.nosExpandidos), to_string(resultado.nosVisitados),
+                to_string(resultado.metricas.maiorAberta), to_string(tempos.size()), to_string(tempos.front()),
+                to_string(mediana), to_string(tempos.back()),
+                to_string(static_cast<long long>(resultado.nosExpandidos / (max(mediana, 1LL) / 1e9))),
+                picoKB >= 0 ? to_string(picoKB) : ""};
+
+            if (json)
+            {
+                saida << (primeiraLinha ? "" : ",\n") << "{";
+                for (size_t c = 0; c < colunas.size(); ++c)
+                {
+                    bool numero = !valores[c].empty() && valores[c].find_first_not_of("0123456789") == string::npos;
+                    saida << (c ? "," : "") << textoJson(colunas[c]) << ":" << (numero ? valores[c] : textoJson(valores[c]));
+                }
+                saida << "}";
+            }
+            else
+            {
+                for (size_t c = 0; c < colunas.size(); ++c)
+                    saida << (c ? "," : "") << valores[c];
+                saida << endl;
+            }
+            primeiraLinha = false;
+        }
+        cerr << "Instancia " << k + 1 << "/" << opcoes.instancias << " concluida" << endl;
+    }
+    if (json)
+        saida << "\n]}" << endl;
+    return 0;
+}
+
+// Verificações de regressão do modo --autoteste: cada uma registra uma
+// descrição e o resultado, e as falhas são listadas na saída
+class Autoteste
+{
+public:
+    void verificar(bool ok, const string &descricao)
+    {
+        verificacoes++;
+        if (ok)
+            return;
+        falhas++;
+        cout << "FALHA: " << descricao << endl;
+    }
+
+    int concluir() const
+    {
+        cout << "Autoteste: " << verificacoes << " verificacoes, " << falhas << " falhas" << endl;
+        return falhas == 0 ? 0 : 1;
+    }
+
+private:
+    int verificacoes = 0, falhas = 0;
+};
+
+// Confere se o caminho sai do estado inicial, termina no objetivo e cada
+// passo corresponde a um movimento
+bool caminhoValido(const vector<Capacidade> &jarros, const vector<vector<int>> &caminho)
+{
+    Instancia inst = criarInstancia(jarros);
+    vector<Movimento> movimentos = listarMovimentos(inst.n);
+    if (caminho.empty() || caminho.front() != converterEstado(jarros) || !atingiuObjetivos(inst, caminho.back().data()))
+        return false;
+    for (size_t passo = 1; passo < caminho.size(); ++passo)
+    {
+        bool existe = false;
+        for (const Movimento &mov : movimentos)
+        {
+            vector<int> niveis = caminho[passo - 1];
+            aplicarMovimento(inst, niveis.data(), mov);
+            existe = existe || niveis == caminho[passo];
+        }
+        if (!existe)
+            return false;
+    }
+    return true;
+}
+
+string descreverInstancia(const vector<Capacidade> &jarros)
+{
+    string capacidades, objetivos, iniciais;
+    for (const auto &jarro : jarros)
+    {
+        capacidades += " " + to_string(jarro.capacidadeMax);
+        objetivos += " " + to_string(jarro.objetivo);
+        iniciais += " " + to_string(jarro.capacidadeAtual);
+    }
+    return "capacidades" + capacidades + "; objetivos" + objetivos + "; iniciais" + iniciais;
+}
+
+// Com limite de profundidade, o Backtracking (sequencial e paralelo) deve
+// achar solução exatamente quando a profundidade da BFS cabe no limite
+void verificarBacktrackingLimitado(Autoteste &teste, const vector<Capacidade> &jarros)
+{
+    ResultadoBusca largura = buscaEmLargura(jarros);
+    int otima = largura.encontrou ? largura.custo : -1;
+    for (int limite : {otima - 1, otima, otima + 2, 3})
+    {
+        if (limite < 1)
+            continue;
+        bool deveAchar = otima >= 0 && otima <= limite;
+        for (int paralelo = 0; paralelo < 2; ++paralelo)
+        {
+            ResultadoBusca resultado = paralelo ? buscaEmProfundidadeParalela(jarros, 2, limite) : buscaBacktracking(jarros, limite);
+            bool ok = resultado.encontrou == deveAchar &&
+                      (!resultado.encontrou || (resultado.custo <= limite && caminhoValido(jarros, resultado.caminho)));
+            teste.verificar(ok, string(paralelo ? "backtracking-paralelo" : "backtracking") + " com limite " + to_string(limite) +
+                                    " (BFS: " + to_string(otima) + ") em " + descreverInstancia(jarros));
+        }
+    }
+}
+
+// Em instância com solução, o IDA* deve achar um caminho que termina no
+// objetivo; com o banco de padrões (admissível), também ótimo. Os bancos das
+// instâncias daqui cabem no limite do IDA*, que não pode voltar à soma. As
+// insolúveis ficam de fora: sem visitados, esgotar os limites de f leva tempo
+// exponencial
+void verificarIDAEstrela(Autoteste &teste, const vector<Capacidade> &jarros)
+{
+    ResultadoBusca largura = buscaEmLargura(jarros);
+    if (!largura.encontrou)
+        return;
+    TipoHeuristica anterior = configuracao.heuristica;
+    for (TipoHeuristica heuristica : {HEURISTICA_SOMA, HEURISTICA_PADROES})
+    {
+        configuracao.heuristica = heuristica;
+        for (int usarTabela = 0; usarTabela < 2; ++usarTabela)
+        {
+            ResultadoBusca resultado = buscaIDAEstrela(jarros, usarTabela);
+            bool admissivel = false;
+            for (const auto &detalhe : resultado.detalhes)
+                admissivel = admissivel || (detalhe.first == "Heuristica" && detalhe.second == "banco de padroes");
+            bool ok = resultado.encontrou && caminhoValido(jarros, resultado.caminho) &&
+                      (heuristica != HEURISTICA_PADROES || (admissivel && resultado.custo == largura.custo));
+            teste.verificar(ok, string(usarTabela ? "ida-tt" : "ida") + " com heuristica " +
+                                    (heuristica == HEURISTICA_PADROES ? "padroes" : "soma") + " em " + descreverInstancia(jarros));
+        }
+    }
+    configuracao.heuristica = anterior;
+}
+
+// A busca de fronteira acha a mesma profundidade da BFS e, sem solução,
+// expande cada estado alcançável uma única vez (os fechados retidos impedem
+// reexpansões também quando o grafo tem ciclos)
+void verificarFronteira(Autoteste &teste, const vector<Capacidade> &jarros)
+{
+    ResultadoBusca largura = buscaEmLargura(jarros);
+    ResultadoBusca resultado = buscaFronteira(jarros);
+    bool ok = resultado.encontrou == largura.encontrou &&
+              (!resultado.encontrou || (resultado.custo == largura.custo && caminhoValido(jarros, resultado.caminho)));
+    if (ok && !resultado.encontrou)
+    {
+        ResultadoBusca densa = buscaEmLarguraDensa(jarros, 1);
+        for (const auto &detalhe : densa.detalhes)
+        {
+            if (detalhe.first == "Estados alcancaveis")
+                ok = to_string(resultado.nosExpandidos) == detalhe.second;
+        }
+    }
+    teste.verificar(ok, "fronteira em " + descreverInstancia(jarros));
+}
+
+// O replanejamento acha o custo da BFS na primeira chamada e depois que o
+// início anda um passo pelo caminho, reparando a busca ou refazendo-a pela BFS
+void verificarIncremental(Autoteste &teste, const vector<Capacidade> &jarros)
+{
+    ResultadoBusca largura = buscaEmLargura(jarros);
+    ResultadoBusca primeira = buscaIncremental(jarros);
+    bool ok = primeira.encontrou == largura.encontrou && (!largura.encontrou || primeira.custo == largura.custo);
+    if (ok && largura.encontrou && largura.custo > 0)
+    {
+        vector<Capacidade> deslocados = jarros;
+        for (size_t i = 0; i < deslocados.size(); ++i)
+            deslocados[i].capacidadeAtual = largura.caminho[1][i];
+        ResultadoBusca segunda = buscaIncremental(deslocados);
+        ok = segunda.encontrou && segunda.custo == largura.custo - 1 && caminhoValido(deslocados, segunda.caminho);
+    }
+    teste.verificar(ok, "incremental em " + descreverInstancia(jarros));
+}
+
+// Objetivo acima da capacidade de um jarro não tem solução. As buscas que
+// empacotam o estado numa chave não podem codificá-lo: o valor transbordaria
+// para o campo vizinho e casaria com outro estado.
+void verificarObjetivoForaDaCapacidade(Autoteste &teste)
+{
+    vector<Capacidade> jarros = {{0, 3, 4}, {0, 5, 0}};
+    for (const auto &algoritmo : algoritmosDisponiveis())
+    {
+        ResultadoBusca resultado = algoritmo.executar(jarros);
+        teste.verificar(!resultado.encontrou && resultado.caminho.empty(),
+                        algoritmo.nome + " sem solucao para objetivo fora da capacidade");
+    }
+}
+
+// Capacidades grandes não podem virar padrões do tamanho da capacidade nem
+// BFS de O(capacidade²): o banco fica pequeno e o A* acha o custo da BFS
+void verificarBancoPadroesGrande(Autoteste &teste)
+{
+    vector<vector<Capacidade>> instancias = {
+        {{0, 100000, 1}, {0, 99999, 0}},
+        {{0, 100000000, 0}, {0, 3, 3}},
+        {{0, 1000000000, 0}, {0, 3, 3}},
+    };
+    TipoHeuristica anterior = configuracao.heuristica;
+    configuracao.heuristica = HEURISTICA_PADROES;
+    for (const auto &jarros : instancias)
+    {
+        BancoPadroes banco(criarInstancia(jarros));
+        ResultadoBusca largura = buscaEmLargura(jarros);
+        ResultadoBusca resultado = buscaAEstrela(jarros);
+        bool ok = banco.construido() && banco.bytes() <= (static_cast<size_t>(1) << 20) * sizeof(uint16_t) &&
+                  resultado.encontrou && resultado.custo == largura.custo;
+        teste.verificar(ok, "banco de padroes com capacidades grandes em " + descreverInstancia(jarros));
+    }
+    configuracao.heuristica = anterior;
+}
+
+// Modo --autoteste: verificações de regressão sobre instâncias fixas e
+// geradas com semente fixa; retorna 0 se todas passarem
+int executarAutoteste()
+{
+    Autoteste teste;
+    vector<vector<Capacidade>> instancias = {
+        {{0, 3, 0}, {0, 5, 4}, {8, 8, 4}}, // alcançado primeiro por um caminho longo
+        {{0, 4, 0}, {0, 3, 2}, {0, 9, 0}},
+        {{1, 1, 1}, {3, 3, 2}},            // IDA* com várias iterações e o jarro 0 não vazio
+        {{9, 14, 9}, {3, 13, 7}, {6, 6, 0}, {9, 11, 9}, {8, 11, 6}, {14, 14, 1}},
+    };
+    OpcoesBenchmark opcoes;
+    opcoes.minCapacidade = 2;
+    opcoes.maxCapacidade = 9;
+    GeradorAleatorio aleatorio(2024);
+    for (int k = 0; k < 150; ++k)
+        instancias.push_back(gerarInstanciaBenchmark(aleatorio, opcoes, aleatorio.entre(1, 100) > 20));
+
+    for (const auto &jarros : instancias)
+    {
+        verificarBacktrackingLimitado(teste, jarros);
+        verificarIDAEstrela(teste, jarros);
+        verificarFronteira(teste, jarros);
+        verificarIncremental(teste, jarros);
+    }
+    verificarObjetivoForaDaCapacidade(teste);
+    verificarBancoPadroesGrande(teste);
+    return teste.concluir();
+}
+
+// Menu de configurações das buscas
+void menuConfiguracoes()
+{
+    cout << "Lista aberta das buscas com custo (atual: " << nomeListaAberta(configuracao.listaAberta) << ")" << endl;
+    cout << "1. Heap binario" << endl;
+    cout << "2. Baldes (FIFO nos empates)" << endl;
+    cout << "3. Baldes (LIFO nos empates)" << endl;
+    cout << "Heuristica do A* e variantes, a Gulosa usa sempre a soma (atual: "
+         << (configuracao.heuristica == HEURISTICA_PADROES ? "banco de padroes" : "soma das diferencas") << ")" << endl;
+    cout << "4. Soma das diferencas ate o objetivo" << endl;
+    cout << "5. Banco de padroes (admissivel)" << endl;
+    cout << "6. Limite de profundidade do Backtracking (atual: " << configuracao.profundidadeMaximaBacktracking << ", 0 = sem limite)" << endl;
+    cout << "7. Orcamento do cache de tabelas retrogradas (atual: " << (configuracao.orcamentoCacheRetrogrado >> 20) << " MB)" << endl;
+    cout << "8. Simetria entre jarros iguais (atual: " << (configuracao.simetria ? "ativa" : "desativada") << ")" << endl;
+    cout << "9. Intervalo das amostras de metricas durante a busca (atual: " << configuracao.intervaloAmostrasMs << " ms, 0 = desligadas)" << endl;
+    cout << "A. Memoria da BFS externa (atual: " << (configuracao.memoriaBfsExterna >> 20) << " MB)" << endl;
+    cout << "B. Diretorio da BFS externa (atual: "
+         << (configuracao.diretorioBfsExterna.empty() ? "temporario do sistema" : configuracao.diretorioBfsExterna) << ")" << endl;
+    cout << "C. Resolvedores especializados para 2 a 8 jarros (atual: "
+         << (configuracao.resolvedoresEspecializados ? "ativos" : "desativados") << ")" << endl;
+    cout << "D. Memoria da BFS densa (atual: " << (configuracao.memoriaBfsDensa >> 20) << " MB)" << endl;
+    cout << "E. Peso inicial da busca anytime (atual: " << configuracao.pesoInicialAnytime << ")" << endl;
+    cout << "F. Reducao do peso por iteracao da busca anytime (atual: " << configuracao.reducaoPesoAnytime << ")" << endl;
+    cout << "G. Expansao parcial na Ordenada, Gulosa e A* (atual: "
+         << (configuracao.expansaoParcial ? "ativa" : "desativada") << ")" << endl;
+    cout << "H. Algoritmos do portfolio (atual: " << configuracao.algoritmosPortfolio << ")" << endl;
+    cout << "I. Aceitacao do portfolio (atual: " << (configuracao.portfolioOtimo ? "somente solucao otima" : "qualquer solucao") << ")" << endl;
+    cout << "J. Participantes do portfolio ao mesmo tempo (atual: " << configuracao.corredoresPortfolio << ", 0 = todos)" << endl;
+    cout << "K. Orcamento do cache de bancos de padroes (atual: " << (configuracao.orcamentoBancoPadroes >> 20) << " MB)" << endl;
+    cout << "Opcao: ";
+    char opcao = 0;
+    cin >> opcao;
+    if (opcao == '1')
+        configuracao.listaAberta = LISTA_HEAP;
+    else if (opcao == '2')
+        configuracao.listaAberta = LISTA_BALDES_FIFO;
+    else if (opcao == '3')
+        configuracao.listaAberta = LISTA_BALDES_LIFO;
+    else if (opcao == '4')
+        configuracao.heuristica = HEURISTICA_SOMA;
+    else if (opcao == '5')
+        configuracao.heuristica = HEURISTICA_PADROES;
+    else if (opcao == '6')
+    {
+        cout << "Profundidade maxima: ";
+        cin >> configuracao.profundidadeMaximaBacktracking;
+    }
+    else if (opcao == '7')
+    {
+        size_t megabytes = 0;
+        cout << "Orcamento em MB: ";
+        cin >> megabytes;
+        configuracao.orcamentoCacheRetrogrado = megabytes << 20;
+    }
+    else if (opcao == '8')
+        configuracao.simetria = !configuracao.simetria;
+    else if (opcao == '9')
+    {
+        cout << "Intervalo em ms: ";
+        cin >> configuracao.intervaloAmostrasMs;
+    }
+    else if (opcao == 'a' || opcao == 'A')
+    {
+        size_t megabytes = 0;
+        cout << "Memoria em MB: ";
+        cin >> megabytes;
+        configuracao.memoriaBfsExterna = megabytes << 20;
+    }
+    else if (opcao == 'b' || opcao == 'B')
+    {
+        cout << "Diretorio: ";
+        cin >> configuracao.diretorioBfsExterna;
+    }
+    else if (opcao == 'c' || opcao == 'C')
+        configuracao.resolvedoresEspecializados = !configuracao.resolvedoresEspecializados;
+    else if (opcao == 'd' || opcao == 'D')
+    {
+        size_t megabytes = 0;
+        cout << "Memoria em MB: ";
+        cin >> megabytes;
+        configuracao.memoriaBfsDensa = megabytes << 20;
+    }
+    else if (opcao == 'e' || opcao == 'E')
+    {
+        cout << "Peso inicial (>= 1): ";
+        cin >> configuracao.pesoInicialAnytime;
+    }
+    else if (opcao == 'f' || opcao == 'F')
+    {
+        cout << "Reducao por iteracao: ";
+        cin >> configuracao.reducaoPesoAnytime;
+    }
+    else if (opcao == 'g' || opcao == 'G')
+        configuracao.expansaoParcial = !configuracao.expansaoParcial;
+    else if (opcao == 'h' || opcao == 'H')
+    {
+        cout << "Algoritmos separados por virgula (nome ou nome:limite de nos): ";
+        cin >> configuracao.algoritmosPortfolio;
+    }
+    else if (opcao == 'i' || opcao == 'I')
+        configuracao.portfolioOtimo = !configuracao.portfolioOtimo;
+    else if (opcao == 'j' || opcao == 'J')
+    {
+        cout << "Participantes ao mesmo tempo: ";
+        cin >> configuracao.corredoresPortfolio;
+    }
+    else if (opcao == 'k' || opcao == 'K')
+    {
+        size_t megabytes = 0;
+        cout << "Orcamento em MB: ";
+        cin >> megabytes;
+        configuracao.orcamentoBancoPadroes = megabytes << 20;
+    }
+}
+
+void exibirUso()
+{
+    cout << "Uso: jarro                      modo interativo" << endl;
+    cout << "     jarro --lote ARQUIVO|-     resolve instancias em lote" << endl;
+    cout << "           [--threads N] [--tempo-limite MS] [--limite-nos N]" << endl;
+    cout << "     jarro --benchmark          compara os algoritmos em instancias geradas" << endl;
+    cout << "           [--semente S] [--instancias K] [--jarros MIN MAX] [--capacidade MIN MAX]" << endl;
+    cout << "           [--insoluveis PERCENTUAL] [--aquecimento W] [--repeticoes R]" << endl;
+    cout << "           [--algoritmos a,b,...] [--formato csv|json] [--saida ARQUIVO]" << endl;
+    cout << "           [--tempo-limite MS] [--limite-nos N]" << endl;
+    cout << "     jarro --autoteste          verificacoes de regressao das buscas" << endl;
+    cout << "     jarro --servico            atende pedidos na entrada padrao, um JSON por linha" << endl;
+    cout << "           [--socket CAMINHO] [--sem-caminho] [--tempo-limite MS] [--limite-nos N]" << endl;
+    cout << "           comandos: estatisticas, sair, encerrar" << endl;
+    cout << "     jarro --gerar-base ARQUIVO \"CAPACIDADES\" \"OBJETIVOS\"" << endl;
+    cout << "                                resolve todos os estados da configuracao e grava a base" << endl;
+    cout << "     --base ARQUIVO             mapeia uma base gerada; o algoritmo retrograda a consulta" << endl;
+    cout << "                                sem busca quando capacidades e objetivos conferem" << endl;
+    cout << "     --amostras MS              emite metricas na saida de erro a cada MS durante as buscas" << endl;
+    cout << "     --memoria-externa MB       memoria da bfs-externa (padrao 64)" << endl;
+    cout << "     --diretorio-externo DIR    arquivos da bfs-externa (padrao: temporario)" << endl;
+    cout << "     --memoria-densa MB         limite dos mapas da bfs-densa (padrao 256)" << endl;
+    cout << "     --lista-aberta heap|baldes|baldes-lifo  lista aberta da UCS, Gulosa e A* (padrao heap)" << endl;
+    cout << "     --portfolio a,b:N,...      participantes do algoritmo portfolio (N = limite de nos)" << endl;
+    cout << "     --aceitar qualquer|otima   resultado que encerra a corrida do portfolio" << endl;
+    cout << "     --corredores N             participantes do portfolio ao mesmo tempo (0 = todos)" << endl;
+    cout << "Cada linha do lote ou pedido do servico: algoritmo; capacidades; objetivos; niveis iniciais" << endl;
+    cout << "Algoritmos:";
+    for (const auto &algoritmo : algoritmosDisponiveis())
+        cout << " " << algoritmo.nome;
+    cout << endl;
+}
+
+/*_____________MAIN___________*/
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        OpcoesLote opcoes;
+        OpcoesBenchmark benchmark;
+        OpcoesServico servico;
+        bool lote = false, modoBenchmark = false, modoServico = false;
+        string arquivoBase;
+        vector<int> capacidadesBase, objetivosBase;
+        for (int k = 1; k < argc; ++k)
+        {
+            string argumento = argv[k];
+            bool temValor = k + 1 < argc, temDoisValores = k + 2 < argc;
+            if (argumento == "--lote" && temValor)
+            {
+                lote = true;
+                opcoes.arquivo = argv[++k];
+            }
+            else if (argumento == "--benchmark")
+                modoBenchmark = true;
+            else if (argumento == "--autoteste")
+                return executarAutoteste();
+            else if (argumento == "--servico")
+                modoServico = true;
+            else if (argumento == "--socket" && temValor)
+            {
+                modoServico = true;
+                servico.socket = argv[++k];
+            }
+            else if (argumento == "--sem-caminho")
+                servico.caminho = false;
+            else if (argumento == "--gerar-base" && k + 3 < argc)
+            {
+                bool validos[2];
+                arquivoBase = argv[++k];
+                capacidadesBase = lerInteiros(argv[++k], validos[0]);
+                objetivosBase = lerInteiros(argv[++k], validos[1]);
+                if (!validos[0] || !validos[1] || capacidadesBase.empty() || capacidadesBase.size() != objetivosBase.size())
+                {
+                    cerr << "--gerar-base: capacidades e objetivos devem ser listas de inteiros do mesmo tamanho" << endl;
+                    return 1;
+                }
+            }
+            else if (argumento == "--base" && temValor)
+            {
+                string erro;
+                auto base = make_unique<BaseSolucoes>();
+                if (!base->abrir(argv[++k], erro))
+                {
+                    cerr << "--base " << argv[k] << ": " << erro << endl;
+                    return 1;
+                }
+                basesSolucoes.push_back(move(base));
+            }
+            else if (argumento == "--lista-aberta" && temValor)
+            {
+                string tipo = argv[++k];
+                if (tipo == "heap")
+                    configuracao.listaAberta = LISTA_HEAP;
+                else if (tipo == "baldes")
+                    configuracao.listaAberta = LISTA_BALDES_FIFO;
+                else if (tipo == "baldes-lifo")
+                    configuracao.listaAberta = LISTA_BALDES_LIFO;
+                else
+                {
+                    cerr << "--lista-aberta: use heap, baldes ou baldes-lifo" << endl;
+                    return 1;
+                }
+            }
+            else if (argumento == "--portfolio" && temValor)
+                configuracao.algoritmosPortfolio = argv[++k];
+            else if (argumento == "--aceitar" && temValor)
+                configuracao.portfolioOtimo = string(argv[++k]) == "otima";
+            else if (argumento == "--corredores" && temValor)
+                configuracao.corredoresPortfolio = atoi(argv[++k]);
+            else if (argumento == "--threads" && temValor)
+                opcoes.threads = atoi(argv[++k]);
+            else if (argumento == "--tempo-limite" && temValor)
+                opcoes.tempoLimiteMs = benchmark.tempoLimiteMs = servico.tempoLimiteMs = atoll(argv[++k]);
+            else if (argumento == "--limite-nos" && temValor)
+                opcoes.limiteNos = benchmark.limiteNos = servico.limiteNos = atoll(argv[++k]);
+            else if (argumento == "--amostras" && temValor)
+                configuracao.intervaloAmostrasMs = atoll(argv[++k]);
+            else if (argumento == "--memoria-externa" && temValor)
+                configuracao.memoriaBfsExterna = static_cast<size_t>(atoll(argv[++k])) << 20;
+            else if (argumento == "--diretorio-externo" && temValor)
+                configuracao.diretorioBfsExterna = argv[++k];
+            else if (argumento == "--memoria-densa" && temValor)
+                configuracao.memoriaBfsDensa = static_cast<size_t>(atoll(argv[++k])) << 20;
+            else if (argumento == "--semente" && temValor)
+            {
+                string texto = argv[++k];
+                bool valida = !texto.empty() && texto.find_first_not_of("0123456789") == string::npos;
+                try
+                {
+                    if (valida)
+                        benchmark.semente = stoull(texto);
+                }
+                catch (const out_of_range &)
+                {
+                    valida = false;
+                }
+                if (!valida)
+                {
+                    cerr << "--semente: use um inteiro sem sinal de ate 64 bits" << endl;
+                    return 1;
+                }
+            }
+            else if (argumento == "--instancias" && temValor)
+                benchmark.instancias = atoi(argv[++k]);
+            else if (argumento == "--jarros" && temDoisValores)
+            {
+                benchmark.minJarros = atoi(argv[++k]);
+                benchmark.maxJarros = atoi(argv[++k]);
+            }
+            else if (argumento == "--capacidade" && temDoisValores)
+            {
+                benchmark.minCapacidade = atoi(argv[++k]);
+                benchmark.maxCapacidade = atoi(argv[++k]);
+            }
+            else if (argumento == "--insoluveis" && temValor)
+                benchmark.percentualInsoluveis = atoi(argv[++k]);
+            else if (argumento == "--aquecimento" && temValor)
+                benchmark.aquecimento = atoi(argv[++k]);
+            else if (argumento == "--repeticoes" && temValor)
+                benchmark.repeticoes = atoi(argv[++k]);
+            else if (argumento == "--algoritmos" && temValor)
+                benchmark.algoritmos = argv[++k];
+            else if (argumento == "--formato" && temValor)
+            {
+                benchmark.formato = argv[++k];
+                if (benchmark.formato != "csv" && benchmark.formato != "json")
+                {
+                    cerr << "--formato: use csv ou json" << endl;
+                    return 1;
+                }
+            }
+            else if (argumento == "--saida" && temValor)
+                benchmark.saida = argv[++k];
+            else
+            {
+                exibirUso();
+                return argumento == "--ajuda" ? 0 : 1;
+            }
+        }
+        if (!arquivoBase.empty())
+            return gerarBaseSolucoes(arquivoBase, capacidadesBase, objetivosBase);
+        if (modoBenchmark)
+            return executarBenchmark(benchmark);
+        if (modoServico)
+            return executarServico(servico);
+        if (lote)
+            return executarLote(opcoes);
+        if (basesSolucoes.empty())
+        {
+            exibirUso();
+            return 1;
+        }
+        // Só bases carregadas: segue para o modo interativo, onde a opção B as usa
+    }
+
+    int tam = 0;
+
+    cout << "Informe a quantidade de jarros: ";
+    cin >> tam;
+
+    vector<Capacidade> jarros(tam);
+
+    cout << "Informe o volume maximo dos jarros" << endl;
+    for (int i = 0; i < tam; ++i)
+    {
+        cout << "Jarros " << i + 1 << ": ";
+        cin >> jarros[i].capacidadeMax;
+    }
+
+    cout << endl;
+
+    cout << "Informe o objetivo de cada jarro" << endl;
+    for (int i = 0; i < tam; ++i)
+    {
+        cout << "Jarro " << i + 1 << ": ";
+        cin >> jarros[i].objetivo;
+        while (cin && (jarros[i].objetivo < 0 || jarros[i].objetivo > jarros[i].capacidadeMax))
+        {
+            cout << "Objetivo invalido, informe um valor entre 0 e " << jarros[i].capacidadeMax << ": ";
+            cin >> jarros[i].objetivo;
+        }
+    }
+
+    cout << "\nInforme a capacidade atual de cada jarro" << endl;
+    for (int i = 0; i < tam; ++i)
+    {
+        cout << "Jarro " << i + 1 << ": ";
+        cin >> jarros[i].capacidadeAtual;
+        while (cin && (jarros[i].capacidadeAtual < 0 || jarros[i].capacidadeAtual > jarros[i].capacidadeMax))
+        {
+            cout << "Capacidade invalida, informe um valor entre 0 e " << jarros[i].capacidadeMax << ": ";
+            cin >> jarros[i].capacidadeAtual;
+        }
+    }
+    /*
+        // Executar as buscas
+
+        vector<Capacidade> jarros =
+        {
+        {0, 4, 0}, // Jarro 1: capacidade atual = 0, capacidade máxima = 4, objetivo = 0
+        {0, 3, 2}, // Jarro 2: capacidade atual = 0, capacidade máxima = 3, objetivo = 2
+        {0, 9, 0}  // Jarro 3: capacidade atual = 0, capacidade máxima = 9, objetivo = 0
+        };
+    */
+    char opcao = 0;
+    cout << endl;
+    while (true)
     {
 
         cout << "Escolha o metodo de busca: " << endl;
@@ -600,6 +8197,20 @@ int main()
         cout << "4. Busca Ordenada (UCS)" << endl;
         cout << "5. Busca Gulosa" << endl;
         cout << "6. Busca A*" << endl;
+        cout << "7. Busca em Largura Bidirecional" << endl;
+        cout << "8. Busca em Largura Paralela" << endl;
+        cout << "9. Busca Paralela HDA* (A* ou Ordenada)" << endl;
+        cout << "A. Busca IDA*" << endl;
+        cout << "B. Tabela retrograda (cache por capacidades e objetivos)" << endl;
+        cout << "C. Configuracoes" << endl;
+        cout << "D. Busca em Largura Externa (fronteiras em disco)" << endl;
+        cout << "E. Busca em Largura Densa (2 bits por estado)" << endl;
+        cout << "F. Busca Anytime (ARA*, com prazo e orcamento de nos)" << endl;
+        cout << "G. Busca de Fronteira (BFS sem lista de fechados)" << endl;
+        cout << "H. Busca A* com Expansao Parcial (PEA*)" << endl;
+        cout << "I. Replanejamento incremental (D* Lite, novos niveis ou objetivos)" << endl;
+        cout << "J. Portfolio (corrida entre algoritmos, configurado em C)" << endl;
+        cout << "K. Busca em Profundidade Paralela (roubo de trabalho)" << endl;
         cout << "X. sair" << endl;
         cout << "Opcao: ";
         cin >> opcao;
@@ -607,29 +8218,180 @@ int main()
         switch (opcao)
         {
         case '1':
-            buscaEmLargura(jarros);
+            cout << "Iniciando Busca em Largura..." << endl;
+            exibirEstatisticas(buscaEmLargura(jarros));
             cout << endl;
             break;
         case '2':
-            buscaEmProfundidade(jarros);
+            cout << "Iniciando Busca em Profundidade..." << endl;
+            exibirEstatisticas(buscaEmProfundidade(jarros));
             cout << endl;
             break;
         case '3':
-            buscaBacktrackingRecursiva(jarros);
+            cout << "Iniciando Backtracking..." << endl;
+            exibirEstatisticas(buscaBacktracking(jarros, configuracao.profundidadeMaximaBacktracking));
             cout << endl;
             break;
         case '4':
-            buscaOrdenada(jarros);
+            cout << "Iniciando Busca Ordenada ..." << endl;
+            exibirEstatisticas(buscaOrdenada(jarros));
             cout << endl;
             break;
         case '5':
-            buscaGulosa(jarros);
+            cout << "Iniciando Busca Gulosa..." << endl;
+            exibirEstatisticas(buscaGulosa(jarros));
             cout << endl;
             break;
         case '6':
-            buscaAEstrela(jarros);
+            cout << "Iniciando Busca A*..." << endl;
+            exibirEstatisticas(buscaAEstrela(jarros));
+            cout << endl;
+            break;
+        case '7':
+            cout << "Iniciando Busca em Largura Bidirecional..." << endl;
+            exibirEstatisticas(buscaBidirecional(jarros));
+            cout << endl;
+            break;
+        case '8':
+        {
+            int numThreads = 0;
+            cout << "Numero de threads (0 = automatico, -1 = relatorio de escalabilidade): ";
+            cin >> numThreads;
+            if (numThreads < 0)
+            {
+                relatorioEscalabilidadeBFS(jarros);
+            }
+            else
+            {
+                cout << "Iniciando Busca em Largura Paralela..." << endl;
+                exibirEstatisticas(buscaEmLarguraParalela(jarros, numThreads));
+            }
+            cout << endl;
+            break;
+        }
+        case '9':
+        {
+            int tipo = 1, numThreads = 0;
+            cout << "Busca (1 = A*, 2 = Ordenada): ";
+            cin >> tipo;
+            cout << "Numero de threads (0 = automatico): ";
+            cin >> numThreads;
+            cout << "Iniciando Busca Paralela HDA*..." << endl;
+            exibirEstatisticas(buscaHDA(jarros, numThreads, tipo != 2));
+            cout << endl;
+            break;
+        }
+        case 'a':
+        case 'A':
+        {
+            char tabela = 'n';
+            cout << "Usar tabela de transposicao? (s/n): ";
+            cin >> tabela;
+            cout << "Iniciando Busca IDA*..." << endl;
+            exibirEstatisticas(buscaIDAEstrela(jarros, tabela == 's' || tabela == 'S'));
+            cout << endl;
+            break;
+        }
+        case 'b':
+        case 'B':
+            cout << "Iniciando consulta a Tabela Retrograda..." << endl;
+            exibirEstatisticas(buscaTabelaRetrograda(jarros));
+            cout << endl;
+            break;
+        case 'c':
+        case 'C':
+            menuConfiguracoes();
+            cout << endl;
+            break;
+        case 'd':
+        case 'D':
+            cout << "Iniciando Busca em Largura Externa..." << endl;
+            exibirEstatisticas(buscaEmLarguraExterna(jarros));
+            cout << endl;
+            break;
+        case 'e':
+        case 'E':
+        {
+            int numThreads = 0;
+            cout << "Numero de threads (0 = automatico): ";
+            cin >> numThreads;
+            cout << "Iniciando Busca em Largura Densa..." << endl;
+            exibirEstatisticas(buscaEmLarguraDensa(jarros, numThreads));
+            cout << endl;
+            break;
+        }
+        case 'f':
+        case 'F':
+        {
+            long long prazoMs = 0;
+            ControleBusca controle;
+            cout << "Prazo em ms (0 = sem prazo): ";
+            cin >> prazoMs;
+            cout << "Limite de nos expandidos (0 = sem limite): ";
+            cin >> controle.limiteNos;
+            if (prazoMs > 0)
+                controle.prazo = high_resolution_clock::now() + milliseconds(prazoMs);
+            cout << "Iniciando Busca Anytime (ARA*)..." << endl;
+            EscopoControle escopo(&controle);
+            exibirEstatisticas(buscaAnytime(jarros, [](const SolucaoAnytime &solucao)
+                                            { cout << "Solucao com custo " << solucao.custo << " (peso " << solucao.peso << ", limite "
+                                                   << (solucao.limite > 0 ? to_string(solucao.limite) : "indisponivel") << ", "
+                                                   << solucao.tempoMicros << " us)" << endl; }));
+            cout << endl;
+            break;
+        }
+        case 'g':
+        case 'G':
+            cout << "Iniciando Busca de Fronteira..." << endl;
+            exibirEstatisticas(buscaFronteira(jarros));
             cout << endl;
             break;
+        case 'h':
+        case 'H':
+            cout << "Iniciando Busca A* com Expansao Parcial..." << endl;
+            exibirEstatisticas(buscaExpansaoParcial(jarros, "A* (expansao parcial)", 1, 1));
+            cout << endl;
+            break;
+        case 'i':
+        case 'I':
+        {
+            // As capacidades ficam; os níveis e objetivos podem mudar entre as consultas
+            char alterar = 'n';
+            cout << "Alterar niveis iniciais e objetivos? (s/n): ";
+            cin >> alterar;
+            if (alterar == 's' || alterar == 'S')
+            {
+                for (int i = 0; i < tam; ++i)
+                {
+                    cout << "Jarro " << i + 1 << " (nivel objetivo): ";
+                    cin >> jarros[i].capacidadeAtual >> jarros[i].objetivo;
+                    jarros[i].capacidadeAtual = max(0, min(jarros[i].capacidadeAtual, jarros[i].capacidadeMax));
+                }
+            }
+            cout << "Iniciando Replanejamento Incremental..." << endl;
+            exibirEstatisticas(buscaIncremental(jarros));
+            cout << endl;
+            break;
+        }
+        case 'j':
+        case 'J':
+            cout << "Iniciando Portfolio (" << configuracao.algoritmosPortfolio << ")..." << endl;
+            exibirEstatisticas(buscaPortfolio(jarros));
+            cout << endl;
+            break;
+        case 'k':
+        case 'K':
+        {
+            int numThreads = 0, profundidade = 0;
+            cout << "Numero de threads (0 = automatico): ";
+            cin >> numThreads;
+            cout << "Limite de profundidade (0 = sem limite, como na DFS): ";
+            cin >> profundidade;
+            cout << "Iniciando Busca em Profundidade Paralela..." << endl;
+            exibirEstatisticas(buscaEmProfundidadeParalela(jarros, numThreads, max(0, profundidade)));
+            cout << endl;
+            break;
+        }
         case 'x':
             exit(1);
             break;